@@ -48,6 +48,14 @@ template <int N, typename T1, typename T2> class DotProduct : public ScalarExpr<
     template <typename T> struct subscript_to_double {
         static constexpr bool value = std::is_same<typename subscript_result_of<T, std::size_t>::type, double>::value;
     };
+    // value evaluates to true if the components of T can be evaluated at a point of dual type D
+    template <typename T, typename D> static constexpr bool subscript_to_dual() {
+        if constexpr (subscript_to_double<T>::value) {
+            return true;
+        } else {
+            return dual_invocable<std::decay_t<typename subscript_result_of<T, std::size_t>::type>, D>;
+        }
+    }
    public:
     // constructor
     DotProduct(const T1& op1, const T2& op2) : op1_(op1), op2_(op2) { }
@@ -71,6 +79,20 @@ template <int N, typename T1, typename T2> class DotProduct : public ScalarExpr<
         }
         return result;
     }
+    template <typename D>
+    D operator()(const Eigen::Matrix<D, N, 1>& x) const
+        requires(subscript_to_dual<T1, D>() && subscript_to_dual<T2, D>()) {
+        D result(0.0);
+        auto eval = [&x](const auto& op) -> D {
+            if constexpr (std::is_same_v<std::decay_t<decltype(op)>, double>) {
+                return D(op);
+            } else {
+                return op(x);
+            }
+        };
+        for (int i = 0; i < dot_product_outer_size(); ++i) { result += eval(op1_[i]) * eval(op2_[i]); }
+        return result;
+    }
     template <typename T> const DotProduct<N, T1, T2>& forward(T i) const {
         op1_.forward(i);
         op2_.forward(i);
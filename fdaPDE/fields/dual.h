@@ -0,0 +1,135 @@
+// This file is part of fdaPDE, a C++ library for physics-informed
+// spatial and functional data analysis.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef __DUAL_H__
+#define __DUAL_H__
+
+#include <cmath>
+#include <concepts>
+#include <type_traits>
+
+#include "../utils/symbols.h"
+
+namespace fdapde {
+namespace core {
+
+// a dual number val + eps * \epsilon, \epsilon^2 = 0, for forward-mode automatic differentiation. Evaluating f at
+// x + \epsilon * v gives f(x) + \epsilon * (\nabla f(x) \cdot v). Nesting (Dual<Dual<double>>) gives second order
+// derivatives. Math functions are found by ADL, hence generic code should call them unqualified (after a using std::f)
+template <typename T> class Dual {
+   public:
+    T val {}, eps {};
+    // constructors
+    Dual() = default;
+    Dual(double val) : val(val), eps(0) { }
+    Dual(const T& val, const T& eps) : val(val), eps(eps) { }
+    // arithmetic
+    Dual& operator+=(const Dual& rhs) {
+        val += rhs.val, eps += rhs.eps;
+        return *this;
+    }
+    Dual& operator-=(const Dual& rhs) {
+        val -= rhs.val, eps -= rhs.eps;
+        return *this;
+    }
+    Dual& operator*=(const Dual& rhs) {
+        eps = eps * rhs.val + val * rhs.eps;
+        val *= rhs.val;
+        return *this;
+    }
+    Dual& operator/=(const Dual& rhs) {
+        eps = (eps * rhs.val - val * rhs.eps) / (rhs.val * rhs.val);
+        val /= rhs.val;
+        return *this;
+    }
+    Dual operator-() const { return Dual(-val, -eps); }
+    Dual operator+() const { return *this; }
+};
+
+template <typename T> struct is_dual : std::false_type { };
+template <typename T> struct is_dual<Dual<T>> : std::true_type { };
+
+// binary operators, mixed dual-double arithmetic is resolved here since template deduction ignores conversions
+#define DEFINE_DUAL_BINARY_OPERATOR(OPERATOR, ASSIGN_OPERATOR)                                                         \
+    template <typename T> Dual<T> OPERATOR(Dual<T> lhs, const Dual<T>& rhs) { return lhs ASSIGN_OPERATOR rhs; }        \
+    template <typename T> Dual<T> OPERATOR(Dual<T> lhs, double rhs) { return lhs ASSIGN_OPERATOR Dual<T>(rhs); }       \
+    template <typename T> Dual<T> OPERATOR(double lhs, const Dual<T>& rhs) { return Dual<T>(lhs) ASSIGN_OPERATOR rhs; }
+DEFINE_DUAL_BINARY_OPERATOR(operator+, +=)
+DEFINE_DUAL_BINARY_OPERATOR(operator-, -=)
+DEFINE_DUAL_BINARY_OPERATOR(operator*, *=)
+DEFINE_DUAL_BINARY_OPERATOR(operator/, /=)
+
+// comparisons only involve the value part, so that branching code takes the same path it takes on doubles
+#define DEFINE_DUAL_COMPARISON_OPERATOR(OPERATOR)                                                                      \
+    template <typename T> bool operator OPERATOR(const Dual<T>& lhs, const Dual<T>& rhs) {                             \
+        return lhs.val OPERATOR rhs.val;                                                                               \
+    }                                                                                                                  \
+    template <typename T> bool operator OPERATOR(const Dual<T>& lhs, double rhs) { return lhs.val OPERATOR rhs; }      \
+    template <typename T> bool operator OPERATOR(double lhs, const Dual<T>& rhs) { return lhs OPERATOR rhs.val; }
+DEFINE_DUAL_COMPARISON_OPERATOR(<)
+DEFINE_DUAL_COMPARISON_OPERATOR(>)
+DEFINE_DUAL_COMPARISON_OPERATOR(<=)
+DEFINE_DUAL_COMPARISON_OPERATOR(>=)
+DEFINE_DUAL_COMPARISON_OPERATOR(==)
+DEFINE_DUAL_COMPARISON_OPERATOR(!=)
+
+// math functions, f(val + \epsilon * eps) = f(val) + \epsilon * f'(val) * eps
+template <typename T> Dual<T> sin(const Dual<T>& x) {
+    using std::sin, std::cos;
+    return Dual<T>(sin(x.val), cos(x.val) * x.eps);
+}
+template <typename T> Dual<T> cos(const Dual<T>& x) {
+    using std::sin, std::cos;
+    return Dual<T>(cos(x.val), -sin(x.val) * x.eps);
+}
+template <typename T> Dual<T> tan(const Dual<T>& x) {
+    using std::tan;
+    T t = tan(x.val);
+    return Dual<T>(t, (1.0 + t * t) * x.eps);
+}
+template <typename T> Dual<T> exp(const Dual<T>& x) {
+    using std::exp;
+    T e = exp(x.val);
+    return Dual<T>(e, e * x.eps);
+}
+template <typename T> Dual<T> log(const Dual<T>& x) {
+    using std::log;
+    return Dual<T>(log(x.val), x.eps / x.val);
+}
+template <typename T> Dual<T> sqrt(const Dual<T>& x) {
+    using std::sqrt;
+    T s = sqrt(x.val);
+    return Dual<T>(s, x.eps / (2.0 * s));
+}
+template <typename T> Dual<T> abs(const Dual<T>& x) { return x.val < 0 ? -x : x; }
+template <typename T> Dual<T> pow(const Dual<T>& x, double p) {
+    using std::pow;
+    return Dual<T>(pow(x.val, p), p * pow(x.val, p - 1) * x.eps);
+}
+template <typename T> Dual<T> pow(const Dual<T>& x, const Dual<T>& p) { return exp(p * log(x)); }
+template <typename T> Dual<T> pow(double x, const Dual<T>& p) { return exp(p * std::log(x)); }
+
+// true if E can be evaluated at a point with coordinates of dual type T (and returns a T)
+template <typename E, typename T>
+concept dual_invocable = is_dual<T>::value && requires(const E& e, const Eigen::Matrix<T, E::static_inner_size, 1>& p) {
+    { e(p) } -> std::same_as<T>;
+};
+
+}   // namespace core
+}   // namespace fdapde
+
+#endif   // __DUAL_H__
@@ -19,6 +19,7 @@
 
 #include <type_traits>
 #include "../utils/symbols.h"
+#include "dual.h"
 
 namespace fdapde {
 namespace core {
@@ -42,6 +43,12 @@ class FieldPartialDerivative<N, 1, OP> : public ScalarExpr<N, FieldPartialDeriva
    public:
     FieldPartialDerivative(const OP& op, int i, double h, int inner_size) : Base(inner_size), op_(op), i_(i), h_(h) {}
     inline double operator()(VectorType x) const {   // must pass by copy
+        if constexpr (dual_invocable<OP, Dual<double>>) {
+            // exact derivative by forward-mode automatic differentiation, seeding direction e_i
+            Eigen::Matrix<Dual<double>, N, 1> x_ = x.template cast<Dual<double>>();
+            x_[i_].eps = 1;
+            return op_(x_).eps;
+        }
         double result;
         x[i_] = x[i_] + h_;
         result = op_(x);   // f(x + h)
@@ -64,6 +71,14 @@ class FieldPartialDerivative<N, 2, OP> : public ScalarExpr<N, FieldPartialDeriva
     FieldPartialDerivative(const OP& op, int i, int j, double h, int inner_size) :
         Base(inner_size), op_(op), i_(i), j_(j), h_(h) { }
     inline double operator()(VectorType x) const {   // must pass by copy
+        if constexpr (dual_invocable<OP, Dual<Dual<double>>>) {
+            // exact derivative by nested forward-mode automatic differentiation, seeding directions e_i (outer) and
+            // e_j (inner). The \epsilon_i \epsilon_j coefficient of the result is df^2/(dx_i dx_j)
+            Eigen::Matrix<Dual<Dual<double>>, N, 1> x_ = x.template cast<Dual<Dual<double>>>();
+            x_[j_].val.eps = 1;
+            x_[i_].eps.val = 1;
+            return op_(x_).eps.eps;
+        }
         double result;
         if (i_ != j_) {   // df^2/(dx_i dx_j)
             x[i_] = x[i_] + h_; x[j_] = x[j_] + h_;
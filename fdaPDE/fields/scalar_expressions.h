@@ -19,6 +19,7 @@
 
 #include <type_traits>
 #include "../utils/symbols.h"
+#include "dual.h"
 
 namespace fdapde {
 namespace core {
@@ -40,12 +41,18 @@ struct ScalarBase { };
     ScalarBinOp<N, Scalar<N>, E, FUNCTOR> OPERATOR(double op1, const ScalarExpr<N, E>& op2) {                          \
         return ScalarBinOp<N, Scalar<N>, E, FUNCTOR>(Scalar<N>(op1, op2.get().inner_size()), op2.get(), FUNCTOR());    \
     }                                                                                                                  \
-// macro for the definition of unary operators on scalar fields
+// macro for the definition of unary operators on scalar fields. FUNCTION is called unqualified, so that overloads for
+// dual numbers are found by ADL
 #define DEFINE_SCALAR_UNARY_OPERATOR(OPERATOR, FUNCTION)                                                               \
+    struct scalar_##OPERATOR##_op {                                                                                    \
+        template <typename T> T operator()(const T& x) const {                                                         \
+            using std::FUNCTION;                                                                                       \
+            return FUNCTION(x);                                                                                        \
+        }                                                                                                              \
+    };                                                                                                                 \
     template <int N, typename E>                                                                                       \
-    ScalarUnOp<N, E, std::function<double(double)>> OPERATOR(const ScalarExpr<N, E>& op1) {                            \
-        std::function<double(double)> OPERATOR_ = [](double x) -> double { return FUNCTION(x); };                      \
-        return ScalarUnOp<N, E, std::function<double(double)>>(op1.get(), OPERATOR_, op1.get().inner_size());          \
+    ScalarUnOp<N, E, scalar_##OPERATOR##_op> OPERATOR(const ScalarExpr<N, E>& op1) {                                   \
+        return ScalarUnOp<N, E, scalar_##OPERATOR##_op>(op1.get(), scalar_##OPERATOR##_op(), op1.get().inner_size());  \
     }
 
 // forward declaration
@@ -92,6 +99,10 @@ template <int N> class Scalar : public ScalarExpr<N, Scalar<N>> {
     static constexpr int NestAsRef = 0;
     Scalar(double value, int n) : Base(n), value_(value) { }
     inline double operator()([[maybe_unused]] const VectorType& p) const { return value_; };
+    template <typename T>
+    T operator()([[maybe_unused]] const Eigen::Matrix<T, N, 1>& p) const requires(is_dual<T>::value) {
+        return T(value_);
+    }
 };
 
 // wraps an n_rows x 1 vector of data, acts as a double once forwarded the matrix row
@@ -104,6 +115,10 @@ template <int N> class DiscretizedScalarField : public ScalarExpr<N, Discretized
     DiscretizedScalarField() = default;
     DiscretizedScalarField(MatrixType& data) : data_(&data) {};
     double operator()([[maybe_unused]] const SVector<N>& p) const { return value_; }
+    template <typename T>
+    T operator()([[maybe_unused]] const Eigen::Matrix<T, N, 1>& p) const requires(is_dual<T>::value) {
+        return T(value_);
+    }
     void forward(int i) const { value_ = data_->operator()(i, 0); }   // impose value of value_
 };
 
@@ -129,6 +144,12 @@ class ScalarBinOp : public ScalarExpr<N, ScalarBinOp<N, OP1, OP2, BinaryOperatio
         if constexpr (N == Dynamic) { fdapde_assert(p.rows() == Base::inner_size()); }
         return f_(op1_(p), op2_(p));
     }
+    // evaluation at dual point, available if both operands support it
+    template <typename T>
+    T operator()(const Eigen::Matrix<T, N, 1>& p) const requires(dual_invocable<OP1, T> && dual_invocable<OP2, T>) {
+        if constexpr (N == Dynamic) { fdapde_assert(p.rows() == Base::inner_size()); }
+        return f_(op1_(p), op2_(p));
+    }
     // forward to child nodes
     template <typename T> const ScalarBinOp<N, OP1, OP2, BinaryOperation>& forward(T i) const {
         op1_.forward(i); op2_.forward(i);
@@ -154,12 +175,15 @@ class ScalarUnOp : public ScalarExpr<N, ScalarUnOp<N, OP, UnaryOperation>> {
     // constructor
     ScalarUnOp(const OP& op, UnaryOperation f, int n) : Base(n), op_(op), f_(f) {};
     double operator()(const VectorType& p) const { return f_(op_(p)); }
+    template <typename T> T operator()(const Eigen::Matrix<T, N, 1>& p) const requires(dual_invocable<OP, T>) {
+        return f_(op_(p));
+    }
 };
-DEFINE_SCALAR_UNARY_OPERATOR(sin, std::sin)
-DEFINE_SCALAR_UNARY_OPERATOR(cos, std::cos)
-DEFINE_SCALAR_UNARY_OPERATOR(tan, std::tan)
-DEFINE_SCALAR_UNARY_OPERATOR(exp, std::exp)
-DEFINE_SCALAR_UNARY_OPERATOR(log, std::log)
+DEFINE_SCALAR_UNARY_OPERATOR(sin, sin)
+DEFINE_SCALAR_UNARY_OPERATOR(cos, cos)
+DEFINE_SCALAR_UNARY_OPERATOR(tan, tan)
+DEFINE_SCALAR_UNARY_OPERATOR(exp, exp)
+DEFINE_SCALAR_UNARY_OPERATOR(log, log)
 
 // unary negation operation
 template <int N, typename OP> class ScalarNegationOp : public ScalarExpr<N, ScalarNegationOp<N, OP>> {
@@ -173,6 +197,9 @@ template <int N, typename OP> class ScalarNegationOp : public ScalarExpr<N, Scal
     // constructor
     ScalarNegationOp(const OP& op, int n) : Base(n), op_(op) {};  
     double operator()(const VectorType& p) const { return -op_(p); }
+    template <typename T> T operator()(const Eigen::Matrix<T, N, 1>& p) const requires(dual_invocable<OP, T>) {
+        return -op_(p);
+    }
     // call parameter evaluation on stored operand
     template <typename T> const ScalarNegationOp<N, OP>& forward(T i) const {
         op_.forward(i);
@@ -85,6 +85,14 @@ class ScalarField : public ScalarExpr<N, ScalarField<N, F>> {
     // evaluation at point
     inline double operator()(const VectorType& x) const { return f_(x); };
     inline double operator()(const VectorType& x) { return f_(x); };
+    // evaluation at dual point, available if the wrapped functor is generic in the coordinates type (e.g. a generic
+    // lambda), in which case derive() and derive_twice() are computed by automatic differentiation
+    template <typename T>
+    T operator()(const Eigen::Matrix<T, N, 1>& x) const
+        requires(is_dual<T>::value && std::is_same_v<std::invoke_result_t<const F&, const Eigen::Matrix<T, N, 1>&>, T>)
+    {
+        return f_(x);
+    }
    protected:
     FieldType f_ {};
 };
@@ -33,6 +33,7 @@
 #include "finite_elements/fem_assembler.h"
 #include "finite_elements/basis/multivariate_polynomial.h"
 #include "finite_elements/basis/lagrangian_basis.h"
+#include "finite_elements/basis/streaming_gram.h"
 #include "finite_elements/basis/reference_element.h"
 #include "finite_elements/solvers/fem_solver_base.h"
 #include "finite_elements/solvers/fem_solver_selector.h"
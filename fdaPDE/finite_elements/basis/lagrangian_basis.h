@@ -17,8 +17,13 @@
 #ifndef __LAGRANGIAN_BASIS_H__
 #define __LAGRANGIAN_BASIS_H__
 
+#include <bit>
+#include <limits>
 #include <unordered_set>
 
+#include "../../geometry/cell_traversal.h"
+#include "../../linear_algebra/binary_matrix.h"
+#include "../../multithreading/parallel_for.h"
 #include "../../pde/symbols.h"
 #include "../../utils/compile_time.h"
 #include "../../utils/symbols.h"
@@ -58,9 +63,22 @@ template <typename MeshType, int Order> class LagrangianBasis {
         int size() const { return basis_.size(); }
         const_iterator begin() const { return basis_.cbegin(); }
         const_iterator end() const { return basis_.cend(); }
+        // batch evaluation of the whole basis at a set of points (one per row), [\Psi]_{ij} = \psi_j(points.row(i))
+        DMatrix<double> eval(const DMatrix<double>& points) const {
+            return MultivariatePolynomial<M, R>::monomials(points) * coeff_;
+        }
+        // batch evaluation of the basis gradients, the k-th matrix stores the derivatives along direction k
+        std::array<DMatrix<double>, M> eval_grad(const DMatrix<double>& points) const {
+            std::array<DMatrix<double>, M> grad;
+            for (int k = 0; k < M; ++k) {
+                grad[k] = MultivariatePolynomial<M, R>::monomials_grad(points, k) * coeff_;
+            }
+            return grad;
+        }
        private:
         std::array<std::array<double, M_>, n_basis> nodes_;   // nodes of the Lagrangian basis
         std::array<MultivariatePolynomial<M_, R_>, n_basis> basis_;
+        SMatrix<n_basis> coeff_;   // i-th column: monomial coefficients of the i-th basis function
         // solves the Vandermonde system for the computation of polynomial coefficients
         void compute_coefficients_(const std::array<std::array<double, M_>, n_basis>& nodes) {
             // build vandermonde matrix
@@ -81,6 +99,7 @@ template <typename MeshType, int Order> class LagrangianBasis {
                 b[i] = 1;
                 // solve linear system V*a = b
                 SVector<n_basis> a = invV.solve(b);
+                coeff_.col(i) = a;
                 // store basis
                 std::array<double, n_basis> coeff;
                 std::copy(a.data(), a.data() + n_basis, coeff.begin());
@@ -134,6 +153,27 @@ template <typename MeshType, int Order> class LagrangianBasis {
         }
         return;
     }
+    // locate phase: cell containing each location (-1 if outside domain) and its reference coordinates
+    static void locate_(
+      const MeshType& domain, const DMatrix<double>& locs, int n_chunks, DVector<int>& cell_ids,
+      DMatrix<double>& ref_coords) {
+        constexpr int N = MeshType::embed_dim;
+        cell_ids.resize(locs.rows());
+        ref_coords.resize(locs.rows(), M);
+        const auto& locator = domain.location_policy();   // build point location structure before going parallel
+        parallel_for_chunks(locs.rows(), n_chunks, [&](int begin, int end, [[maybe_unused]] int t) {
+            for (int i = begin; i < end; ++i) {
+                SVector<N> p(locs.row(i));
+                cell_ids[i] = locator.locate(p);
+                if (cell_ids[i] == -1) {
+                    ref_coords.row(i).setConstant(std::numeric_limits<double>::quiet_NaN());
+                    continue;
+                }
+                auto e = domain.cell(cell_ids[i]);
+                ref_coords.row(i) = e.invJ() * (p - e.node(0));
+            }
+        });
+    }
    public:
     static constexpr int R = Order;                 // basis order
     static constexpr int M = MeshType::local_dim;   // input space dimension
@@ -148,8 +188,8 @@ template <typename MeshType, int Order> class LagrangianBasis {
 
     // returns a pair of matrices (\Psi, D) where: \Psi is the matrix of basis functions evaluations according
     // to the given policy, D is a policy-dependent vector (see the specific policy for details)
-    template <template <typename> typename EvaluationPolicy>
-    std::pair<SpMatrix<double>, DVector<double>> eval(const DMatrix<double>& locs) const {
+    template <template <typename> typename EvaluationPolicy, typename LocsType>
+    std::pair<SpMatrix<double>, DVector<double>> eval(const LocsType& locs) const {
         return EvaluationPolicy<LagrangianBasis<MeshType, R>>::eval(*domain_, ref_basis_, locs, size_, dofs_);
     }
     int size() const { return size_; }
@@ -164,39 +204,158 @@ template <typename MeshType, int Order> class LagrangianBasis {
             DMatrix<double> coords;
             coords.resize(size_, MeshType::embed_dim);
             coords.topRows(domain_->n_nodes()) = domain_->nodes();   // copy coordinates of elements' vertices
-            std::unordered_set<int> visited;                         // set of already visited dofs
             std::array<SVector<MeshType::local_dim + 1>, n_dof_per_element> ref_coords =
               ReferenceElement<MeshType::local_dim, R>().bary_coords;
-            // cycle over all mesh elements
-            for (typename MeshType::cell_iterator e = domain_->cells_begin(); e != domain_->cells_end(); ++e) {
-                auto dofs = dofs_.row(e->id());
+            // a dof shared by several cells is mapped by the first cell (in id order) containing it
+            std::vector<int> owner(size_, -1);
+            for (int i = 0; i < dofs_.rows(); ++i) {
                 for (int j = MeshType::n_nodes_per_cell; j < n_dof_per_element; ++j) {
-                    if (visited.find(dofs[j]) == visited.end()) {
-                        // map point from reference to physical element
-                        coords.row(dofs[j]) = e->J() * ref_coords[j].template tail<MeshType::local_dim>() + e->node(0);
-                        visited.insert(dofs[j]);
-                    }
+                    if (owner[dofs_(i, j)] == -1) owner[dofs_(i, j)] = i;
                 }
             }
+            for_each_cell(*domain_, [&](const typename MeshType::CellType& e) {
+                auto dofs = dofs_.row(e.id());
+                for (int j = MeshType::n_nodes_per_cell; j < n_dof_per_element; ++j) {
+                    if (owner[dofs[j]] == e.id()) {   // map point from reference to physical element
+                        coords.row(dofs[j]) = e.J() * ref_coords[j].template tail<MeshType::local_dim>() + e.node(0);
+                    }
+                }
+            });
             return coords;
         }
     }
     static ReferenceBasis ref_basis() { return ReferenceBasis {}; }
-    // given a coefficient vector c \in \mathbb{R}^size_, evaluates the corresponding basis expansion at locs
+
+    // a set of locations located once over the physical domain, stores for each location the id of the containing
+    // cell (-1 if outside the domain), its reference coordinates and the resulting \Psi matrix, [\Psi]_{ij} = \psi_j(p_i)
+    class EvaluationPlan {
+       private:
+        static constexpr int N = MeshType::embed_dim;
+        static constexpr int grain_size = 1024;   // minimum number of locations processed by a single thread
+        DVector<int> cell_ids_;        // for each location, the id of the cell containing it
+        DMatrix<double> ref_coords_;   // for each location, its coordinates on the reference element
+        Eigen::SparseMatrix<double, Eigen::RowMajor> Psi_;
+       public:
+        EvaluationPlan() = default;
+        EvaluationPlan(
+          const MeshType& domain, const ReferenceBasis& basis, const DMatrix<double>& locs, int n_basis,
+          const DMatrix<int>& dofs, int n_threads = std::thread::hardware_concurrency()) {
+            fdapde_assert(locs.cols() == N);
+            int n_locs = locs.rows();
+            int n_chunks = n_parallel_chunks(n_locs, grain_size, n_threads);
+            locate_(domain, locs, n_chunks, cell_ids_, ref_coords_);
+            // each located point has exactly n_dof_per_element nonzeros, set row pointers of \Psi in CSR format
+            Psi_.resize(n_locs, n_basis);
+            int* outer = Psi_.outerIndexPtr();
+            outer[0] = 0;
+            for (int i = 0; i < n_locs; ++i) { outer[i + 1] = outer[i] + (cell_ids_[i] != -1 ? n_dof_per_element : 0); }
+            Psi_.resizeNonZeros(outer[n_locs]);
+            // fill phase: write basis evaluations directly in the CSR arrays, column indexes sorted by dof
+            parallel_for_chunks(n_locs, n_chunks, [&](int begin, int end, [[maybe_unused]] int k) {
+                std::array<std::pair<int, double>, n_dof_per_element> row;
+                DMatrix<double> psi = basis.eval(ref_coords_.middleRows(begin, end - begin));   // batch evaluation
+                for (int i = begin; i < end; ++i) {
+                    if (cell_ids_[i] == -1) continue;
+                    for (int h = 0; h < n_dof_per_element; ++h) {
+                        row[h] = {dofs(cell_ids_[i], h), psi(i - begin, h)};
+                    }
+                    std::sort(row.begin(), row.end());
+                    for (int h = 0; h < n_dof_per_element; ++h) {
+                        Psi_.innerIndexPtr()[outer[i] + h] = row[h].first;
+                        Psi_.valuePtr()[outer[i] + h] = row[h].second;
+                    }
+                }
+            });
+        }
+        // evaluates the basis expansions whose coefficients are the columns of c, all at once
+        template <typename CoeffType> DMatrix<double> operator()(const Eigen::MatrixBase<CoeffType>& c) const {
+            fdapde_assert(c.rows() == Psi_.cols());
+            return Psi_ * c;
+        }
+        // getters
+        const DVector<int>& cell_ids() const { return cell_ids_; }
+        const DMatrix<double>& ref_coords() const { return ref_coords_; }
+        const Eigen::SparseMatrix<double, Eigen::RowMajor>& Psi() const { return Psi_; }
+        int n_locs() const { return Psi_.rows(); }
+    };
+    EvaluationPlan
+    evaluation_plan(const DMatrix<double>& locs, int n_threads = std::thread::hardware_concurrency()) const {
+        return EvaluationPlan(*domain_, ref_basis_, locs, size_, dofs_, n_threads);
+    }
+    // given a coefficient vector c \in \mathbb{R}^size_, evaluates the corresponding basis expansion at locs. Locations
+    // outside the domain evaluate to zero. If the same locs are used more than once, prefer an EvaluationPlan
     DVector<double> operator()(const DVector<double>& c, const DMatrix<double>& locs) const {
         fdapde_assert(c.rows() == size_ && locs.cols() == MeshType::embed_dim);
-        // locate elements
-        DVector<int> element_ids = domain_->locate(locs);
-        DVector<double> result = DVector<double>::Zero(locs.rows());
-        for (int i = 0; i < locs.rows(); ++i) {
-            auto e = domain_->cell(element_ids[i]);
-            // evaluate basis expansion \sum_{i=1}^size_ c_i \psi_i(x) at p
-            SVector<MeshType::embed_dim> p(locs.row(i));
-            for (int h = 0; h < ref_basis_.size(); ++h) {
-                result[i] += c[e.node_ids()[h]] * ref_basis_[h](e.invJ() * (p - e.node(0)));
+        return evaluation_plan(locs)(c);
+    }
+    // computes the pair (\Psi^\top W \Psi, \Psi^\top W y), with W = diag(weights), without assembling \Psi.
+    // Observations are grouped by cell, each cell contributes with a local n_dof_per_element^2 block, as in FEM assembly
+    std::pair<SpMatrix<double>, DVector<double>> gram(
+      const DMatrix<double>& locs, const DVector<double>& weights, const DVector<double>& y,
+      int n_threads = std::thread::hardware_concurrency()) const {
+        fdapde_assert(locs.cols() == MeshType::embed_dim && weights.rows() == locs.rows() && y.rows() == locs.rows());
+        int n_locs = locs.rows(), n_cells = domain_->n_cells();
+        DVector<int> cell_ids;
+        DMatrix<double> ref_coords;
+        int n_locs_chunks = n_parallel_chunks(n_locs, 1024, n_threads);
+        locate_(*domain_, locs, n_locs_chunks, cell_ids, ref_coords);
+        DMatrix<double> psi_table(n_locs, n_dof_per_element);   // [psi_table]_{ij} = \psi_j(p_i), batch evaluated
+        parallel_for_chunks(n_locs, n_locs_chunks, [&](int begin, int end, [[maybe_unused]] int t) {
+            psi_table.middleRows(begin, end - begin) = ref_basis_.eval(ref_coords.middleRows(begin, end - begin));
+        });
+        // bucket observations by cell (counting sort), observations outside the domain are discarded
+        std::vector<int> offsets(n_cells + 1, 0);
+        for (int i = 0; i < n_locs; ++i) {
+            if (cell_ids[i] != -1) offsets[cell_ids[i] + 1]++;
+        }
+        for (int c = 0; c < n_cells; ++c) { offsets[c + 1] += offsets[c]; }
+        std::vector<int> obs(offsets[n_cells]), cursor(offsets.begin(), offsets.end() - 1);
+        for (int i = 0; i < n_locs; ++i) {
+            if (cell_ids[i] != -1) obs[cursor[cell_ids[i]]++] = i;
+        }
+        // assembly loop over cells, each thread accumulates triplets in private buffers. Local right hand sides are
+        // stored per cell and summed up in cell order, as triplets are, so that the result does not depend on n_threads
+        int n_chunks = n_parallel_chunks(n_cells, 1024, n_threads);
+        std::vector<std::vector<fdapde::Triplet<double>>> triplet_lists(n_chunks);
+        DMatrix<double> rhs = DMatrix<double>::Zero(n_cells, n_dof_per_element);
+        parallel_for_chunks(n_cells, n_chunks, [&](int begin, int end, int t) {
+            SMatrix<n_dof_per_element> local_gram;
+            SVector<n_dof_per_element> local_rhs, psi;
+            for (int c = begin; c < end; ++c) {
+                if (offsets[c] == offsets[c + 1]) continue;   // no observation in this cell
+                local_gram.setZero();
+                local_rhs.setZero();
+                for (int j = offsets[c]; j < offsets[c + 1]; ++j) {
+                    int i = obs[j];
+                    psi = psi_table.row(i).transpose();
+                    local_gram.noalias() += weights[i] * psi * psi.transpose();
+                    local_rhs += (weights[i] * y[i]) * psi;
+                }
+                for (int h = 0; h < n_dof_per_element; ++h) {
+                    for (int k = 0; k < n_dof_per_element; ++k) {
+                        triplet_lists[t].emplace_back(dofs_(c, h), dofs_(c, k), local_gram(h, k));
+                    }
+                    rhs(c, h) = local_rhs[h];
+                }
             }
+        });
+        // merge thread-local contributions
+        std::vector<fdapde::Triplet<double>> triplet_list;
+        std::size_t n_triplets = 0;
+        for (const auto& list : triplet_lists) { n_triplets += list.size(); }
+        triplet_list.reserve(n_triplets);
+        for (auto& list : triplet_lists) {
+            triplet_list.insert(triplet_list.end(), list.begin(), list.end());
+            std::vector<fdapde::Triplet<double>>().swap(list);   // release memory as soon as possible
+        }
+        SpMatrix<double> G(size_, size_);
+        G.setFromTriplets(triplet_list.begin(), triplet_list.end());
+        G.makeCompressed();
+        DVector<double> b = DVector<double>::Zero(size_);
+        for (int c = 0; c < n_cells; ++c) {
+            for (int h = 0; h < n_dof_per_element; ++h) { b[dofs_(c, h)] += rhs(c, h); }
         }
-        return result;
+        return std::make_pair(std::move(G), std::move(b));
     }
 };
 
@@ -208,28 +367,9 @@ template <typename MeshType, int order> struct pointwise_evaluation<LagrangianBa
       const MeshType& domain, const BasisType& basis, const DMatrix<double>& locs, int n_basis,
       const DMatrix<int>& dofs) {
       fdapde_assert(locs.size() != 0 && locs.cols() == MeshType::embed_dim);
-      // preallocate space
-      SpMatrix<double> Psi(locs.rows(), n_basis);
-      std::vector<fdapde::Triplet<double>> triplet_list;
-      triplet_list.reserve(locs.rows() * basis.size());
-      // locate points
-      DVector<int> element_ids = domain.locate(locs);
-      // build \Psi matrix
-      for (int i = 0, n = locs.rows(); i < n; ++i) {
-          SVector<N> p_i(locs.row(i));
-          if (element_ids[i] != -1) {   // point falls inside domain
-              auto e = domain.cell(element_ids[i]);
-              // update \Psi matrix
-              for (int h = 0, n_basis = basis.size(); h < n_basis; ++h) {
-                  triplet_list.emplace_back(
-                    i, dofs(e.id(), h),
-                    basis[h](e.invJ() * (p_i - e.node(0))));   // \psi_j(p_i)
-              }
-          }
-      }
-      // finalize construction
-      Psi.setFromTriplets(triplet_list.begin(), triplet_list.end());
-      Psi.makeCompressed();
+      // locate and fill phases run in parallel over chunks of locations, \Psi is built in CSR format and converted once
+      SpMatrix<double> Psi =
+        typename LagrangianBasis<MeshType, order>::EvaluationPlan(domain, basis, locs, n_basis, dofs).Psi();
       return std::pair(std::move(Psi), DVector<double>::Ones(locs.rows()));
     }
 };
@@ -237,48 +377,153 @@ template <typename MeshType, int order> struct pointwise_evaluation<LagrangianBa
 template <typename MeshType, int order> struct areal_evaluation<LagrangianBasis<MeshType, order>> {
     using BasisType = typename LagrangianBasis<MeshType, order>::ReferenceBasis;
     static constexpr int N = MeshType::embed_dim;
+    static constexpr int n_dof_per_element = LagrangianBasis<MeshType, order>::n_dof_per_element;
+    static constexpr int grain_size = 64;   // minimum number of subdomains processed by a single thread
+   private:
+    // subdomains as lists of cells: the k-th subdomain is made by cells[offsets[k]], ..., cells[offsets[k + 1] - 1]
+    struct Subdomains {
+        std::vector<int> offsets {0};
+        std::vector<int> cells {};
+        void close() { offsets.push_back(cells.size()); }   // no more cells are added to the current subdomain
+    };
     // computes a matrix \Psi such that [\Psi]_{ij} = \int_{D_j} \psi_i, D contains the measures of subdomains
-    static std::pair<SpMatrix<double>, DVector<double>> eval(
-      const MeshType& domain, const BasisType& basis, const DMatrix<double>& locs, int n_basis,
+    static std::pair<SpMatrix<double>, DVector<double>> eval_(
+      const MeshType& domain, const BasisType& basis, const Subdomains& subdomains, int n_basis,
       const DMatrix<int>& dofs) {
-      fdapde_assert(locs.size() != 0 && locs.cols() == domain.n_cells());
-      typename BasisType::Quadrature integrator {};
-      // preallocate space
-      SpMatrix<double> Psi(locs.rows(), n_basis);
-      std::vector<fdapde::Triplet<double>> triplet_list;
-      triplet_list.reserve(locs.rows() * n_basis);
-
-      DVector<double> D(locs.rows());   // measure of subdomains
-      // start construction of \Psi matrix
-      int tail = 0;
-      for (int k = 0, n = locs.rows(); k < n; ++k) {
-            int head = 0;
-            double Di = 0;   // measure of subdomain D_i
-            for (int l = 0, N_ = locs.cols(); l < N_; ++l) {
-                if (locs(k, l) == 1) {   // element with ID l belongs to k-th subdomain
-                    // get element with this ID
-                    auto e = domain.cell(l);
-                    // compute \int_e \psi_h \forall \psi_h defined on e
-                    for (int h = 0, n_basis = basis.size(); h < n_basis; ++h) {
-                        triplet_list.emplace_back(
-                          k, dofs(e.id(), h),
-                          integrator.integrate_cell(e, [&e, &psi_h = basis[h]](const SVector<N>& q) -> double {
-                              return psi_h(e.invJ() * (q - e.node(0)));
-                          }));
-                        head++;
+        typename BasisType::Quadrature integrator {};
+        int n_regions = subdomains.offsets.size() - 1;
+        int n_cells = domain.n_cells();
+        // integrals \int_e \psi_h of the basis functions over cells in some subdomain, computed once for all subdomains
+        std::vector<char> active(n_cells, 0);
+        for (int l : subdomains.cells) { active[l] = 1; }
+        DMatrix<double, Eigen::RowMajor> cell_integrals(n_cells, n_dof_per_element);
+        DVector<double> cell_measures(n_cells);
+        parallel_for_chunks(
+          n_cells, n_parallel_chunks(n_cells, 1024), [&](int begin, int end, [[maybe_unused]] int t) {
+              for (int l = begin; l < end; ++l) {
+                  if (!active[l]) continue;
+                  auto e = domain.cell(l);
+                  for (int h = 0; h < n_dof_per_element; ++h) {
+                      cell_integrals(l, h) =
+                        integrator.integrate_cell(e, [&e, &psi_h = basis[h]](const SVector<N>& q) -> double {
+                            return psi_h(e.invJ() * (q - e.node(0)));
+                        });
+                  }
+                  cell_measures[l] = e.measure();
+              }
+          });
+        // each thread assembles the rows of \Psi relative to its chunk of subdomains from a private triplet buffer
+        int n_chunks = n_parallel_chunks(n_regions, grain_size);
+        DVector<double> D(n_regions);   // measure of subdomains
+        std::vector<Eigen::SparseMatrix<double, Eigen::RowMajor>> blocks(n_chunks);
+        parallel_for_chunks(n_regions, n_chunks, [&](int begin, int end, int t) {
+            std::vector<fdapde::Triplet<double>> triplet_list;
+            for (int k = begin; k < end; ++k) {
+                std::size_t tail = triplet_list.size();
+                double Di = 0;   // measure of subdomain D_i
+                for (int j = subdomains.offsets[k]; j < subdomains.offsets[k + 1]; ++j) {
+                    int l = subdomains.cells[j];
+                    for (int h = 0; h < n_dof_per_element; ++h) {
+                        triplet_list.emplace_back(k - begin, dofs(l, h), cell_integrals(l, h));
                     }
-                    Di += e.measure();   // update measure of subdomain D_i
+                    Di += cell_measures[l];
                 }
+                // divide each \int_{D_i} \psi_j by the measure of subdomain D_i
+                for (std::size_t j = tail; j < triplet_list.size(); ++j) { triplet_list[j].value() /= Di; }
+                D[k] = Di;   // store measure of subdomain
             }
-            // divide each \int_{D_i} \psi_j by the measure of subdomain D_i
-            for (int j = 0; j < head; ++j) { triplet_list[tail + j].value() /= Di; }
-            D[k] = Di;   // store measure of subdomain
-            tail += head;
-      }
-      // finalize construction
-      Psi.setFromTriplets(triplet_list.begin(), triplet_list.end());
-      Psi.makeCompressed();
-      return std::make_pair(std::move(Psi), std::move(D));
+            blocks[t].resize(end - begin, n_basis);
+            blocks[t].setFromTriplets(triplet_list.begin(), triplet_list.end());
+        });
+        // in CSR format the blocks of rows are contiguous, concatenate them
+        Eigen::SparseMatrix<double, Eigen::RowMajor> Psi_csr(n_regions, n_basis);
+        int nnz = 0;
+        for (const auto& block : blocks) { nnz += block.nonZeros(); }
+        Psi_csr.resizeNonZeros(nnz);
+        for (int t = 0, row = 0, offset = 0; t < n_chunks; ++t) {
+            const auto& block = blocks[t];
+            for (int i = 0; i < block.rows(); ++i) { Psi_csr.outerIndexPtr()[row + i] = offset + block.outerIndexPtr()[i]; }
+            std::copy_n(block.innerIndexPtr(), block.nonZeros(), Psi_csr.innerIndexPtr() + offset);
+            std::copy_n(block.valuePtr(), block.nonZeros(), Psi_csr.valuePtr() + offset);
+            row += block.rows();
+            offset += block.nonZeros();
+        }
+        Psi_csr.outerIndexPtr()[n_regions] = nnz;
+        SpMatrix<double> Psi = Psi_csr;
+        return std::make_pair(std::move(Psi), std::move(D));
+    }
+   public:
+    // subdomains given as dense n_regions \times n_cells incidence matrix, [locs]_{kl} = 1 \iff cell l is in D_k
+    static std::pair<SpMatrix<double>, DVector<double>> eval(
+      const MeshType& domain, const BasisType& basis, const DMatrix<double>& locs, int n_basis,
+      const DMatrix<int>& dofs) {
+        fdapde_assert(locs.size() != 0 && locs.cols() == domain.n_cells());
+        Subdomains subdomains;
+        for (int k = 0; k < locs.rows(); ++k) {
+            for (int l = 0; l < locs.cols(); ++l) {
+                if (locs(k, l) == 1) subdomains.cells.push_back(l);
+            }
+            subdomains.close();
+        }
+        return eval_(domain, basis, subdomains, n_basis, dofs);
+    }
+    // subdomains given as a per-cell label, labels[l] = k \iff cell l is in D_k (-1 if l is in no subdomain)
+    static std::pair<SpMatrix<double>, DVector<double>> eval(
+      const MeshType& domain, const BasisType& basis, const DVector<int>& labels, int n_basis,
+      const DMatrix<int>& dofs) {
+        fdapde_assert(labels.size() == domain.n_cells());
+        int n_regions = labels.maxCoeff() + 1;
+        Subdomains subdomains;
+        subdomains.offsets.resize(n_regions + 1, 0);
+        subdomains.cells.resize((labels.array() >= 0).count());
+        for (int l = 0; l < labels.size(); ++l) {   // counting sort of cells by label
+            if (labels[l] >= 0) subdomains.offsets[labels[l] + 1]++;
+        }
+        for (int k = 0; k < n_regions; ++k) { subdomains.offsets[k + 1] += subdomains.offsets[k]; }
+        std::vector<int> cursor(subdomains.offsets.begin(), subdomains.offsets.end() - 1);
+        for (int l = 0; l < labels.size(); ++l) {
+            if (labels[l] >= 0) subdomains.cells[cursor[labels[l]]++] = l;
+        }
+        return eval_(domain, basis, subdomains, n_basis, dofs);
+    }
+    // subdomains given as sparse n_regions \times n_cells incidence matrix
+    template <typename T>
+    static std::pair<SpMatrix<double>, DVector<double>> eval(
+      const MeshType& domain, const BasisType& basis, const Eigen::SparseMatrix<T>& locs, int n_basis,
+      const DMatrix<int>& dofs) {
+        fdapde_assert(locs.cols() == domain.n_cells());
+        Eigen::SparseMatrix<T, Eigen::RowMajor> incidence = locs;
+        Subdomains subdomains;
+        subdomains.cells.reserve(incidence.nonZeros());
+        for (int k = 0; k < incidence.rows(); ++k) {
+            for (typename Eigen::SparseMatrix<T, Eigen::RowMajor>::InnerIterator it(incidence, k); it; ++it) {
+                if (it.value() != T(0)) subdomains.cells.push_back(it.col());
+            }
+            subdomains.close();
+        }
+        return eval_(domain, basis, subdomains, n_basis, dofs);
+    }
+    // subdomains given as binary n_regions \times n_cells incidence matrix
+    static std::pair<SpMatrix<double>, DVector<double>> eval(
+      const MeshType& domain, const BasisType& basis, const BinaryMatrix<Dynamic>& locs, int n_basis,
+      const DMatrix<int>& dofs) {
+        fdapde_assert(locs.cols() == domain.n_cells());
+        using BitPackType = typename BinaryMatrix<Dynamic>::BitPackType;
+        constexpr int PackSize = BinaryMatrix<Dynamic>::PackSize;
+        Subdomains subdomains;
+        long long size = static_cast<long long>(locs.rows()) * locs.cols();
+        int k = 0;   // current subdomain
+        // bits are stored in row-major order, visit only set bits skipping empty packs
+        for (int i = 0; i < locs.bitpacks(); ++i) {
+            for (BitPackType pack = locs.bitpack(i); pack != 0; pack &= pack - 1) {
+                long long idx = static_cast<long long>(i) * PackSize + std::countr_zero(pack);
+                if (idx >= size) break;
+                for (; k < idx / locs.cols(); ++k) { subdomains.close(); }
+                subdomains.cells.push_back(idx % locs.cols());
+            }
+        }
+        for (; k < locs.rows(); ++k) { subdomains.close(); }
+        return eval_(domain, basis, subdomains, n_basis, dofs);
     }
 };
 
@@ -19,6 +19,7 @@
 
 #include <array>
 
+#include "../../utils/assert.h"
 #include "../../utils/compile_time.h"
 #include "../../utils/symbols.h"
 #include "../../fields/scalar_expressions.h"
@@ -133,24 +134,16 @@ template <typename P, typename V> struct MonomialProduct<0, P, V> {   // base ca
     static constexpr double unfold(const P& p, const V& v) { return v[0] == 0 ? 1 : std::pow(p[0], v[0]); }
 };
 
-// unfold the sum of monomials at compile time to produce the complete polynomial expression
-template <int I,        // template recursion loop variable
-          int N,        // total number of monomials to unfold
-          int M,        // polynomial space dimension
-          typename P,   // point where to evaluate the polynomial
-          typename V>   // the whole polynomial PolyTable
-struct MonomialSum {
-    static constexpr double unfold(const std::array<double, N>& c, const P& p, const V& v) {
-        return (c[I] * MonomialProduct<M - 1, SVector<M>, std::array<int, M>>::unfold(p, v[I])) +
-               MonomialSum<I - 1, N, M, P, V>::unfold(c, p, v);
+// powers x_i^k, k = 0, ..., R, of the coordinates of p. Computed once, they are shared by all the monomials of a
+// polynomial, so that its evaluation costs a few multiplications per monomial instead of N calls to std::pow
+template <int N, int R, typename P> std::array<std::array<double, R + 1>, N> monomial_powers(const P& p) {
+    std::array<std::array<double, R + 1>, N> powers;
+    for (int i = 0; i < N; ++i) {
+        powers[i][0] = 1;
+        for (int k = 1; k <= R; ++k) { powers[i][k] = powers[i][k - 1] * p[i]; }
     }
-};
-// end of recursion
-template <int N, int M, typename P, typename V> struct MonomialSum<0, N, M, P, V> {
-    static constexpr double unfold(const std::array<double, N>& c, const P& p, const V& v) {
-        return c[0] * MonomialProduct<M - 1, SVector<M>, std::array<int, M>>::unfold(p, v[0]);
-    }
-};
+    return powers;
+}
 
 // functor implementing the derivative of a multivariate N-dimensional polynomial of degree R along a given direction
 template <int N, int R>
@@ -170,13 +163,15 @@ class PolynomialDerivative : public VectorExpr<N, N, PolynomialDerivative<N, R>>
         coeff_vector_(coeff_vector), i_(i) {};
     // call operator
     inline double operator()(const SVector<N>& p) const {
+        std::array<std::array<double, R + 1>, N> powers = monomial_powers<N, R>(p);
         double value = 0;
         // cycle over monomials
         for (int m = 0; m < n_monomials; ++m) {
-            if (poly_table_[m][i_] != 0)   // skip powers of zero, their derivative is zero
-                value +=
-                  coeff_vector_[m] * poly_table_[m][i_] *
-                  MonomialProduct<N - 1, SVector<N>, std::array<int, N>>::unfold(p, poly_grad_table_[i_][m]);
+            if (poly_table_[m][i_] != 0) {   // skip powers of zero, their derivative is zero
+                double monomial = coeff_vector_[m] * poly_table_[m][i_];
+                for (int j = 0; j < N; ++j) { monomial *= powers[j][poly_grad_table_[i_][m][j]]; }
+                value += monomial;
+            }
         }
         return value;   // return partial derivative
     }
@@ -189,6 +184,17 @@ class MultivariatePolynomial : public ScalarExpr<N, MultivariatePolynomial<N, R>
     static const constexpr int n_monomials = ct_binomial_coefficient(R + N, R);
     std::array<double, n_monomials> coeff_vector_;   // vector of coefficients
     VectorField<N, N, PolynomialDerivative<N, R>> gradient_;
+    // column-wise coordinate powers, the (i * (R + 1) + k)-th column stores x_i^k for all the points
+    static DMatrix<double> monomials_powers_(const DMatrix<double>& points) {
+        DMatrix<double> powers(points.rows(), N * (R + 1));
+        for (int i = 0; i < N; ++i) {
+            powers.col(i * (R + 1)).setOnes();
+            for (int k = 1; k <= R; ++k) {
+                powers.col(i * (R + 1) + k) = powers.col(i * (R + 1) + k - 1).cwiseProduct(points.col(i));
+            }
+        }
+        return powers;
+    }
    public:
     // compute this at compile time once, let public access
     static constexpr PolyTable<N, R> poly_table = ct_poly_exp<N, R>();
@@ -207,10 +213,57 @@ class MultivariatePolynomial : public ScalarExpr<N, MultivariatePolynomial<N, R>
     };
     // evaluate polynomial at point
     double operator()(const SVector<N>& point) const {
-        return MonomialSum<
-          n_monomials - 1, n_monomials, N, SVector<N>,
-          std::array<std::array<int, N>, n_monomials>>::unfold(coeff_vector_, point, poly_table);
+        std::array<std::array<double, R + 1>, N> powers = monomial_powers<N, R>(point);
+        double value = 0;
+        for (int m = 0; m < n_monomials; ++m) {
+            double monomial = coeff_vector_[m];
+            for (int i = 0; i < N; ++i) { monomial *= powers[i][poly_table[m][i]]; }
+            value += monomial;
+        }
+        return value;
     };
+    // batch evaluation at a set of points, one per row of points
+    DVector<double> eval(const DMatrix<double>& points) const {
+        return monomials(points) * Eigen::Map<const SVector<n_monomials>>(coeff_vector_.data());
+    }
+    // batch evaluation of the gradient at a set of points, the i-th row of the result is \nabla p(points.row(i))
+    DMatrix<double> eval_grad(const DMatrix<double>& points) const {
+        DMatrix<double> grad(points.rows(), N);
+        for (int i = 0; i < N; ++i) {
+            grad.col(i) = monomials_grad(points, i) * Eigen::Map<const SVector<n_monomials>>(coeff_vector_.data());
+        }
+        return grad;
+    }
+    // evaluates all the monomials at a set of points, [V]_{ij} = x_i^{e_j} with x_i the i-th row of points and e_j the
+    // j-th row of poly_table. Coordinate powers are shared between monomials and computed column-wise, so that all the
+    // operations are vectorized across points. Multiplication by a coefficient matrix gives many polynomials at once
+    static DMatrix<double> monomials(const DMatrix<double>& points) {
+        fdapde_assert(points.cols() == N);
+        DMatrix<double> powers = monomials_powers_(points);
+        DMatrix<double> V(points.rows(), n_monomials);
+        for (int m = 0; m < n_monomials; ++m) {
+            V.col(m).setOnes();
+            for (int i = 0; i < N; ++i) {
+                if (poly_table[m][i] != 0) V.col(m).array() *= powers.col(i * (R + 1) + poly_table[m][i]).array();
+            }
+        }
+        return V;
+    }
+    // derivatives of all the monomials along direction i at a set of points, [V]_{kj} = \partial_i x_k^{e_j}
+    static DMatrix<double> monomials_grad(const DMatrix<double>& points, int i) {
+        fdapde_assert(points.cols() == N && i >= 0 && i < N);
+        DMatrix<double> powers = monomials_powers_(points);
+        DMatrix<double> V = DMatrix<double>::Zero(points.rows(), n_monomials);
+        for (int m = 0; m < n_monomials; ++m) {
+            if (poly_table[m][i] == 0) continue;   // derivative of a constant along i
+            V.col(m).setConstant(poly_table[m][i]);
+            for (int j = 0; j < N; ++j) {
+                int e = j == i ? poly_table[m][j] - 1 : poly_table[m][j];
+                if (e != 0) V.col(m).array() *= powers.col(j * (R + 1) + e).array();
+            }
+        }
+        return V;
+    }
     VectorField<N, N, PolynomialDerivative<N, R>> derive() const { return gradient_; };   // return callable gradient
     std::array<double, n_monomials> getCoeff() const { return coeff_vector_; }
 };
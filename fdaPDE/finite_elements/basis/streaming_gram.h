@@ -0,0 +1,82 @@
+// This file is part of fdaPDE, a C++ library for physics-informed
+// spatial and functional data analysis.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __STREAMING_GRAM_H__
+#define __STREAMING_GRAM_H__
+
+#include <future>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "../../multithreading/ThreadPool.h"
+#include "../../utils/IO/csv_reader.h"
+#include "../../utils/assert.h"
+#include "../../utils/symbols.h"
+
+namespace fdapde {
+namespace core {
+
+// out-of-core computation of the pair (\Psi^\top W \Psi, \Psi^\top W y) for data sets which do not fit in memory.
+// locs_file stores the locations, data_file the observations y (first column) and, optionally, the weights (second
+// column, unit weights if missing), both in the .csv format accepted by CSVReader. Files are consumed in blocks of
+// chunk_size rows by a three stage pipeline running on the library thread pool: while block k is located and assembled
+// by basis.gram(), block k+1 is read from disk and the contribution of block k-1 is summed up. At most three blocks
+// are alive at the same time
+template <typename BasisType>
+std::pair<SpMatrix<double>, DVector<double>> streaming_gram(
+  const BasisType& basis, const std::string& locs_file, const std::string& data_file, int chunk_size,
+  int n_threads = std::thread::hardware_concurrency()) {
+    fdapde_assert(chunk_size > 0);
+    struct Block {
+        DMatrix<double> locs, data;
+        bool valid = false;
+    };
+    CSVChunkReader<double> locs_reader(locs_file, chunk_size), data_reader(data_file, chunk_size);
+    fdapde_assert(data_reader.cols() == 1 || data_reader.cols() == 2);
+    auto read_block = [&]() -> Block {
+        Block block;
+        bool has_locs = locs_reader.next(block.locs), has_data = data_reader.next(block.data);
+        fdapde_assert(has_locs == has_data && block.locs.rows() == block.data.rows());
+        block.valid = has_locs;
+        return block;
+    };
+
+    SpMatrix<double> G(basis.size(), basis.size());
+    DVector<double> b = DVector<double>::Zero(basis.size());
+    std::future<Block> reading = thread_pool().send_async(read_block);
+    std::future<void> accumulating;
+    while (true) {
+        Block block = reading.get();
+        if (!block.valid) break;
+        reading = thread_pool().send_async(read_block);   // prefetch next block
+        DVector<double> w = block.data.cols() == 2 ? DVector<double>(block.data.col(1)) :
+                                                     DVector<double>::Ones(block.data.rows());
+        auto contribution = basis.gram(block.locs, w, block.data.col(0), n_threads);
+        if (accumulating.valid()) accumulating.get();
+        accumulating = thread_pool().send_async([&G, &b, c = std::move(contribution)]() {
+            G += c.first;
+            b += c.second;
+        });
+    }
+    if (accumulating.valid()) accumulating.get();
+    return std::make_pair(std::move(G), std::move(b));
+}
+
+}   // namespace core
+}   // namespace fdapde
+
+#endif   // __STREAMING_GRAM_H__
@@ -18,10 +18,13 @@
 #define __FEM_ASSEMBLER_H__
 
 #include <memory>
+#include <optional>
+#include <vector>
 
 #include "../fields/field_ptrs.h"
 #include "../fields/scalar_field.h"
 #include "../fields/vector_field.h"
+#include "../geometry/cell_traversal.h"
 #include "../pde/assembler.h"
 #include "../utils/compile_time.h"
 #include "../utils/integration/integrator.h"
@@ -50,65 +53,82 @@ template <typename D, typename B, typename I> class Assembler<FEM, D, B, I> {
 
     // discretization methods
     template <typename E> SpMatrix<double> discretize_operator(const E& op) {
+        return discretize_operator(op, execution::default_policy());
+    }
+    template <typename E, typename Policy> SpMatrix<double> discretize_operator(const E& op, const Policy& policy) {
         constexpr int M = D::local_dim;
         constexpr int N = D::embed_dim;
-        std::vector<Eigen::Triplet<double>> triplet_list;   // store triplets (node_i, node_j, integral_value)
-        SpMatrix<double> discretization_matrix;
-
-        // properly preallocate memory to avoid reallocations
-        triplet_list.reserve(n_basis * mesh_.n_cells());
-        discretization_matrix.resize(dof_, dof_);
-
-        // prepare space for bilinear form components
         using BasisType = typename B::ElementType;
         using NablaType = decltype(std::declval<BasisType>().derive());
-        BasisType buff_psi_i, buff_psi_j;               // basis functions \psi_i, \psi_j
-        NablaType buff_nabla_psi_i, buff_nabla_psi_j;   // gradient of basis functions \nabla \psi_i, \nabla \psi_j
-        Matrix<M, N, M> buff_invJ;        // (J^{-1})^T, being J the inverse of the barycentric matrix of e
-        DVector<double> f(n_basis);       // active solution coefficients on current element e
-        // prepare buffer to be sent to bilinear form
-        auto mem_buffer = std::make_tuple(
-          ScalarPtr(&buff_psi_i), ScalarPtr(&buff_psi_j), VectorPtr(&buff_nabla_psi_i), VectorPtr(&buff_nabla_psi_j),
-          MatrixPtr(&buff_invJ), &f);
-
-        // develop bilinear form expression in an integrable field here once
-        auto weak_form = op.integrate(mem_buffer);   // let the compiler deduce the type of the expression template!
+        // per-chunk buffers the bilinear form expression points to
+        struct Workspace {
+            BasisType buff_psi_i, buff_psi_j;               // basis functions \psi_i, \psi_j
+            NablaType buff_nabla_psi_i, buff_nabla_psi_j;   // gradient of basis functions \nabla \psi_i, \nabla \psi_j
+            Matrix<M, N, M> buff_invJ;   // (J^{-1})^T, being J the inverse of the barycentric matrix of e
+            DVector<double> f;           // active solution coefficients on current element e
+            std::vector<Eigen::Triplet<double>> triplet_list;   // store triplets (node_i, node_j, integral_value)
+            // prepare buffer to be sent to bilinear form
+            auto mem_buffer() {
+                return std::make_tuple(
+                  ScalarPtr(&buff_psi_i), ScalarPtr(&buff_psi_j), VectorPtr(&buff_nabla_psi_i),
+                  VectorPtr(&buff_nabla_psi_j), MatrixPtr(&buff_invJ), &f);
+            }
+        };
+        // develop bilinear form expression in an integrable field once per chunk
+        using WeakFormType = decltype(op.integrate(std::declval<Workspace&>().mem_buffer()));
+        int n_chunks = n_cell_chunks(mesh_, policy);
+        std::vector<std::unique_ptr<Workspace>> workspace(n_chunks);
+        std::vector<std::optional<WeakFormType>> weak_form(n_chunks);
+        for (int k = 0; k < n_chunks; ++k) {
+            workspace[k] = std::make_unique<Workspace>();
+            workspace[k]->f.resize(n_basis);
+            // properly preallocate memory to avoid reallocations
+            workspace[k]->triplet_list.reserve(n_basis * mesh_.n_cells() / n_chunks);
+            weak_form[k].emplace(op.integrate(workspace[k]->mem_buffer()));
+        }
 
-        int current_id;
         // cycle over all mesh elements
-        for (typename D::cell_iterator e = mesh_.cells_begin(); e != mesh_.cells_end(); ++e) {
+        for_each_cell(mesh_, policy, [&](const typename D::CellType& e, int k) {
+            Workspace& ws = *workspace[k];
             // update elements related informations
-            buff_invJ = e->invJ().transpose();
-            current_id = e->id();   // element ID
+            ws.buff_invJ = e.invJ().transpose();
+            int current_id = e.id();   // element ID
 
             if (!is_empty(f_))   // should be bypassed in case of linear operators via an if constexpr!!!
-                for (int dof = 0; dof < n_basis; dof++) { f[dof] = f_[dof_table_(current_id, dof)]; }
+                for (int dof = 0; dof < n_basis; dof++) { ws.f[dof] = f_[dof_table_(current_id, dof)]; }
 
             // consider all pair of nodes
             for (int i = 0; i < n_basis; ++i) {
-                buff_psi_i = reference_basis_[i];
-                buff_nabla_psi_i = buff_psi_i.derive();   // update buffers content
+                ws.buff_psi_i = reference_basis_[i];
+                ws.buff_nabla_psi_i = ws.buff_psi_i.derive();   // update buffers content
                 for (int j = 0; j < n_basis; ++j) {
-                    buff_psi_j = reference_basis_[j];
-                    buff_nabla_psi_j = buff_psi_j.derive();   // update buffers content
+                    ws.buff_psi_j = reference_basis_[j];
+                    ws.buff_nabla_psi_j = ws.buff_psi_j.derive();   // update buffers content
                     if constexpr (is_symmetric<decltype(op)>::value) {
                         // compute only half of the discretization matrix if the operator is symmetric
                         if (dof_table_(current_id, i) >= dof_table_(current_id, j)) {
-                            double value = integrator_.template integrate_weak_form<decltype(op)>(*e, weak_form);
+                            double value = integrator_.template integrate_weak_form<decltype(op)>(e, *weak_form[k]);
 
                             // linearity of the integral is implicitly used during matrix construction, since duplicated
                             // triplets are summed up, see Eigen docs for more details
-                            triplet_list.emplace_back(dof_table_(current_id, i), dof_table_(current_id, j), value);
+                            ws.triplet_list.emplace_back(dof_table_(current_id, i), dof_table_(current_id, j), value);
                         }
                     } else {
                         // not any optimization to perform in the general case
-                        double value = integrator_.template integrate_weak_form<decltype(op)>(*e, weak_form);
-                        triplet_list.emplace_back(dof_table_(current_id, i), dof_table_(current_id, j), value);
+                        double value = integrator_.template integrate_weak_form<decltype(op)>(e, *weak_form[k]);
+                        ws.triplet_list.emplace_back(dof_table_(current_id, i), dof_table_(current_id, j), value);
                     }
                 }
             }
+        });
+        // merge triplets in chunk order, hence in cell order
+        std::vector<Eigen::Triplet<double>>& triplet_list = workspace[0]->triplet_list;
+        for (int k = 1; k < n_chunks; ++k) {
+            triplet_list.insert(
+              triplet_list.end(), workspace[k]->triplet_list.begin(), workspace[k]->triplet_list.end());
         }
         // matrix assembled
+        SpMatrix<double> discretization_matrix(dof_, dof_);
         discretization_matrix.setFromTriplets(triplet_list.begin(), triplet_list.end());
         discretization_matrix.makeCompressed();
 
@@ -120,20 +140,35 @@ template <typename D, typename B, typename I> class Assembler<FEM, D, B, I> {
         }
     }
     template <typename F> DVector<double> discretize_forcing(const F& f) {
-        // allocate space for result vector
-        DVector<double> discretization_vector {};
-        discretization_vector.resize(dof_, 1);   // there are as many basis functions as degrees of freedom on the mesh
-        discretization_vector.fill(0);           // init result vector to zero
-
-        // build forcing vector
-        for (typename D::cell_iterator e = mesh_.cells_begin(); e != mesh_.cells_end(); ++e) {
-            for (int i = 0; i < n_basis; ++i) {
-                // integrate \int_e [f*\psi], exploit integral linearity
-                discretization_vector[dof_table_(e->id(), i)] += integrator_.integrate(*e, f, reference_basis_[i]);
-            }
+        return discretize_forcing(f, execution::default_policy());
+    }
+    template <typename F, typename Policy> DVector<double> discretize_forcing(const F& f, const Policy& policy) {
+        // there are as many basis functions as degrees of freedom on the mesh
+        DVector<double> discretization_vector = DVector<double>::Zero(dof_);
+        auto Phi = integrator_.tabulate(reference_basis_);   // basis values at quadrature nodes, computed once
+        if (n_cell_chunks(mesh_, policy) == 1) {
+            for_each_cell(mesh_, execution::seq, [&](const typename D::CellType& e) {
+                // integrate \int_e [f*\psi_i] for all i, exploit integral linearity
+                SVector<n_basis> local_vector = integrator_.integrate(e, f, Phi);
+                for (int i = 0; i < n_basis; ++i) { discretization_vector[dof_table_(e.id(), i)] += local_vector[i]; }
+            });
+            return discretization_vector;
+        }
+        // cells in different chunks may share a dof: local integrals are computed concurrently and summed up in cell
+        // order afterwards, so that the result is bit-identical to the sequential one whatever the policy. Overhead:
+        // n_cells x n_basis doubles of storage and a serial scatter, cheap compared to quadrature
+        DMatrix<double> local_vector(mesh_.n_cells(), n_basis);
+        for_each_cell(mesh_, policy, [&](const typename D::CellType& e) {
+            local_vector.row(e.id()) = integrator_.integrate(e, f, Phi).transpose();
+        });
+        for (int c = 0; c < mesh_.n_cells(); ++c) {
+            for (int i = 0; i < n_basis; ++i) { discretization_vector[dof_table_(c, i)] += local_vector(c, i); }
         }
         return discretization_vector;
     }
+    // diagonal of the row-sum lumped mass matrix, assembled cell by cell without forming the mass matrix. Since
+    // lagrangian basis functions sum up to one, \sum_j \int_e \psi_i \psi_j = \int_e \psi_i
+    DVector<double> discretize_lumped_mass() { return discretize_forcing(ConstantField<D::embed_dim>(1.0)); }
 };
 
 }   // namespace core
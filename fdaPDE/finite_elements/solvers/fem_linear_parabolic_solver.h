@@ -60,7 +60,12 @@ class FEMLinearParabolicSolver : public FEMSolverBase<D, E, F, Ts...> {
         }
         // execute temporal loop to solve ODE system via forward-euler scheme
         for (std::size_t i = 0; i < m - 1; ++i) {
-            rhs = ((this->mass_) / deltaT_) * this->solution_.col(i) + this->force_.block(n * (i + 1), 0, n, 1);
+            if (this->lump_mass_) {   // diagonal mass, avoid sparse matrix-vector product
+                rhs = (this->lumped_mass_ / deltaT_).cwiseProduct(this->solution_.col(i)) +
+                      this->force_.block(n * (i + 1), 0, n, 1);
+            } else {
+                rhs = ((this->mass_) / deltaT_) * this->solution_.col(i) + this->force_.block(n * (i + 1), 0, n, 1);
+            }
             // impose boundary conditions
             for (auto it = this->boundary_dofs_begin(); it != this->boundary_dofs_end(); ++it) {
                 rhs[*it] = pde.boundary_data()(*it, i + 1);
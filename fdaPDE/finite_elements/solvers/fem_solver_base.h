@@ -23,6 +23,7 @@
 #include "../../utils/symbols.h"
 #include "../../utils/traits.h"
 #include "../../utils/combinatorics.h"
+#include "../../linear_algebra/lumping.h"
 #include "../basis/lagrangian_basis.h"
 #include "../fem_assembler.h"
 #include "../fem_symbols.h"
@@ -51,6 +52,8 @@ template <typename D, typename E, typename F, typename... Ts> class FEMSolverBas
     const DMatrix<double>& force() const { return force_; }
     const SpMatrix<double>& stiff() const { return stiff_; }
     const SpMatrix<double>& mass() const { return mass_; }
+    const DVector<double>& lumped_mass() const { return lumped_mass_; }   // diagonal of mass_, if lumped
+    bool is_mass_lumped() const { return lump_mass_; }
     const Quadrature& integrator() const { return integrator_; }
     const ReferenceBasis& reference_basis() const { return reference_basis_; }
     const FunctionalBasis& basis() const { return basis_; }
@@ -61,6 +64,8 @@ template <typename D, typename E, typename F, typename... Ts> class FEMSolverBas
     bool is_init = false;   // notified true if initialization occurred with no errors
     bool success = false;   // notified true if problem solved with no errors
 
+    // if set, mass_ is replaced by its row-sum lumped (diagonal) version, to be called before init()
+    void set_mass_lumping(bool lump_mass) { lump_mass_ = lump_mass; }
     template <typename PDE> void init(const PDE& pde);
     template <typename PDE> void set_dirichlet_bc(const PDE& pde);
     
@@ -73,9 +78,7 @@ template <typename D, typename E, typename F, typename... Ts> class FEMSolverBas
        public:
         // fetch next boundary dof
         boundary_dofs_iterator& operator++() {
-            index_++;
-            // scan until all nodes have been visited or a boundary node is not found
-            for (; index_ < solver_->n_dofs_ && !solver_->boundary_dofs_[index_]; ++index_);
+            index_ = solver_->boundary_dofs_.find_next(index_ + 1);   // n_dofs_ if no boundary dof is left
             return *this;
         }
         int operator*() const { return index_; }
@@ -83,7 +86,9 @@ template <typename D, typename E, typename F, typename... Ts> class FEMSolverBas
             return lhs.index_ != rhs.index_;
         }
     };
-    boundary_dofs_iterator boundary_dofs_begin() const { return boundary_dofs_iterator(this, 0); }
+    boundary_dofs_iterator boundary_dofs_begin() const {
+        return boundary_dofs_iterator(this, boundary_dofs_.find_next(0));
+    }
     boundary_dofs_iterator boundary_dofs_end() const { return boundary_dofs_iterator(this, n_dofs_); }
    protected:
     Quadrature integrator_ {};              // default to a quadrature rule which is exact for the considered FEM order
@@ -93,6 +98,8 @@ template <typename D, typename E, typename F, typename... Ts> class FEMSolverBas
     DMatrix<double> force_;                 // discretized force [u]_i = \int_D f*\psi_i
     SpMatrix<double> stiff_;                // [stiff_]_{ij} = a(\psi_i, \psi_j), being a(.,.) the bilinear form
     SpMatrix<double> mass_;                 // mass matrix, [mass_]_{ij} = \int_D (\psi_i * \psi_j)
+    DVector<double> lumped_mass_;           // [lumped_mass_]_i = \int_D \psi_i, filled only if lump_mass_ is set
+    bool lump_mass_ = false;                // whether to use a lumped mass matrix
     int n_dofs_ = 0;                        // degrees of freedom, i.e. the maximum ID in the dof_table_
     DMatrix<int> dofs_;                     // for each element, the degrees of freedom associated to it
     BinaryVector<Dynamic> boundary_dofs_;   // unknowns on the boundary of the domain
@@ -133,7 +140,12 @@ void FEMSolverBase<D, E, F, Ts...>::init(const PDE& pde) {
         force_.block(0, 0, n, 1) = assembler.discretize_forcing(pde.forcing_data());
     }
     // compute mass matrix [mass]_{ij} = \int_{\Omega} \phi_i \phi_j
-    mass_ = assembler.discretize_operator(Reaction<FEM, double>(1.0));
+    if (lump_mass_) {
+        lumped_mass_ = assembler.discretize_lumped_mass();
+        mass_ = internals::sparse_diagonal(lumped_mass_);
+    } else {
+        mass_ = assembler.discretize_operator(Reaction<FEM, double>(1.0));
+    }
     is_init = true;
     return;
 }
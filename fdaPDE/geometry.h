@@ -17,6 +17,7 @@
 #ifndef __FDAPDE_GEOMETRY_MODULE_H__
 #define __FDAPDE_GEOMETRY_MODULE_H__
 
+#include "geometry/cell_traversal.h"
 #include "geometry/hyperplane.h"
 #include "geometry/interval.h"
 #include "geometry/kd_tree.h"
@@ -0,0 +1,82 @@
+// This file is part of fdaPDE, a C++ library for physics-informed
+// spatial and functional data analysis.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef __CELL_TRAVERSAL_H__
+#define __CELL_TRAVERSAL_H__
+
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../multithreading/execution_policy.h"
+
+namespace fdapde {
+namespace core {
+
+// number of chunks in which the cells of mesh are split by for_each_cell() under the given policy
+template <typename MeshType, typename Policy> int n_cell_chunks(const MeshType& mesh, const Policy& policy) {
+    return n_chunks(mesh.n_cells(), policy);
+}
+
+// calls f(e) on each cell e of mesh, or f(e, k) if f accepts it, being k in [0, n_cell_chunks(mesh, policy)) the chunk
+// the cell belongs to (useful to index per-thread workspaces). Cells in the same chunk are visited in id order by the
+// same thread, hence f must be safe to call concurrently only on cells of different chunks
+template <typename MeshType, typename Policy, typename F>
+void for_each_cell(const MeshType& mesh, const Policy& policy, F&& f) {
+    for_each_chunk(mesh.n_cells(), policy, [&](int begin, int end, int k) {
+        for (int i = begin; i < end; ++i) {
+            typename MeshType::CellType e = mesh.cell(i);
+            if constexpr (std::is_invocable_v<F, const typename MeshType::CellType&, int>) {
+                f(e, k);
+            } else {
+                f(e);
+            }
+        }
+    });
+}
+template <typename MeshType, typename F> void for_each_cell(const MeshType& mesh, F&& f) {
+    for_each_cell(mesh, execution::default_policy(), std::forward<F>(f));
+}
+
+// computes reduce(init, reduce(t_0, reduce(t_1, ...))) where t_i = transform(e_i), e_i being the i-th cell of mesh.
+// Cells in a chunk are reduced left to right, partial results of chunks are then reduced on the calling thread, in
+// chunk order or along a fixed binary tree for reproducible policies. The sequential policy hence matches the plain
+// loop init = reduce(init, transform(e_i)) for associative ops
+template <typename MeshType, typename Policy, typename T, typename Transform, typename Reduce>
+T transform_reduce_cells(const MeshType& mesh, const Policy& policy, T init, Transform&& transform, Reduce&& reduce) {
+    int n_cells = mesh.n_cells();
+    if (n_cells == 0) return init;
+    std::vector<T> partials(n_cell_chunks(mesh, policy), init);
+    for_each_chunk(n_cells, policy, [&](int begin, int end, int k) {
+        T partial = transform(mesh.cell(begin));
+        for (int i = begin + 1; i < end; ++i) { partial = reduce(partial, transform(mesh.cell(i))); }
+        partials[k] = partial;
+    });
+    if (is_reproducible(policy)) return tree_reduce(partials, init, reduce);
+    for (const T& partial : partials) { init = reduce(init, partial); }
+    return init;
+}
+template <typename MeshType, typename T, typename Transform, typename Reduce>
+T transform_reduce_cells(const MeshType& mesh, T init, Transform&& transform, Reduce&& reduce) {
+    return transform_reduce_cells(
+      mesh, execution::default_policy(), init, std::forward<Transform>(transform), std::forward<Reduce>(reduce));
+}
+
+}   // namespace core
+}   // namespace fdapde
+
+#endif   // __CELL_TRAVERSAL_H__
@@ -18,6 +18,7 @@
 #define __TREE_SEARCH_H__
 
 #include "../utils/symbols.h"
+#include "cell_traversal.h"
 #include "kd_tree.h"
 
 namespace fdapde {
@@ -48,14 +49,13 @@ template <typename MeshType> class TreeSearch {
         DMatrix<double> data;
         data.resize(mesh_->n_cells(), 2 * embed_dim);
         for (int dim = 0; dim < embed_dim; ++dim) { c_[dim] = 1.0 / (mesh_->range()(1, dim) - mesh_->range()(0, dim)); }
-        int i = 0;
-        for (typename MeshType::cell_iterator it = mesh_->cells_begin(); it != mesh_->cells_end(); ++it) {
-            std::pair<SVector<embed_dim>, SVector<embed_dim>> bbox = it->bounding_box();
+        for_each_cell(*mesh_, [&](const typename MeshType::CellType& e) {
+            std::pair<SVector<embed_dim>, SVector<embed_dim>> bbox = e.bounding_box();
             // unit hypercube point scaling
+            int i = e.id();
             data.row(i).leftCols(embed_dim)  = (bbox.first  - mesh_->range().row(0).transpose()).array() * c_.array();
             data.row(i).rightCols(embed_dim) = (bbox.second - mesh_->range().row(0).transpose()).array() * c_.array();
-            ++i;
-        }
+        });
         tree_ = KDTree<2 * embed_dim>(std::move(data));   // organize elements in a KD-tree structure
     }
     // finds all the elements containing p
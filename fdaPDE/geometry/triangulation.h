@@ -17,6 +17,7 @@
 #ifndef __TRIANGULATION_H__
 #define __TRIANGULATION_H__
 
+#include <algorithm>
 #include <array>
 #include <unordered_map>
 #include <vector>
@@ -93,18 +94,16 @@ template <int M, int N, typename Derived> class TriangulationBase {
         const Derived* mesh_;
        public:
         boundary_node_iterator(int index, const Derived* mesh) : Base(index, 0, mesh->n_nodes_), mesh_(mesh) {
-            for (; index_ < mesh_->n_nodes_ && !mesh_->nodes_markers_[index_] != true; ++index_);
+            index_ = mesh_->nodes_markers_.find_next(index_);
             this->val_ = index_;
         }
         boundary_node_iterator& operator++() {
-            index_++;
-            for (; index_ < mesh_->n_nodes_ && !mesh_->nodes_markers_[index_] != true; ++index_);
+            index_ = mesh_->nodes_markers_.find_next(index_ + 1);
             this->val_ = index_;
             return *this;
         }
         boundary_node_iterator& operator--() {
-            --index_;
-            for (; index_ >= 0 && !mesh_->nodes_markers_[index_] != true; --index_);
+            index_ = mesh_->nodes_markers_.find_prev(index_ - 1);
             this->val_ = index_;
             return *this;
         }
@@ -212,27 +211,27 @@ template <int N> class Triangulation<2, N> : public TriangulationBase<2, N, Tria
         using Base = index_based_iterator<edge_iterator, EdgeType>;
         using Base::index_;
         const Triangulation* mesh_;
-        BinaryVector<fdapde::Dynamic> filter_;
+        const BinaryVector<fdapde::Dynamic>* filter_;   // non-owning view on the filter, nullptr visits all edges
        public:
         edge_iterator(int index, const Triangulation* mesh, const BinaryVector<fdapde::Dynamic>& filter) :
-            Base(index, 0, mesh->n_edges_), mesh_(mesh), filter_(filter) {
-            for (; index_ < mesh_->n_edges_ && !filter_[index_]; ++index_);
+            Base(index, 0, mesh->n_edges_), mesh_(mesh), filter_(&filter) {
+            index_ = filter_->find_next(index_);
             if (index_ != mesh_->n_edges_) { Base::val_ = EdgeType(index_, mesh_); }
         }
         edge_iterator(int index, const Triangulation* mesh) :
-            edge_iterator(index, mesh, BinaryVector<fdapde::Dynamic>::Ones(mesh->n_edges_)) { }
+            Base(index, 0, mesh->n_edges_), mesh_(mesh), filter_(nullptr) {
+            if (index_ != mesh_->n_edges_) { Base::val_ = EdgeType(index_, mesh_); }
+        }
         edge_iterator& operator++() {
             // fetch next edge
-            index_++;
-            for (; index_ < mesh_->n_edges_ && !filter_[index_]; ++index_);
+            index_ = filter_ ? filter_->find_next(index_ + 1) : index_ + 1;
             if (index_ == mesh_->n_edges_) return *this;
             Base::val_ = EdgeType(index_, mesh_);
             return *this;
         }
         edge_iterator& operator--() {
             // fetch previous edge
-            index_--;
-            for (; index_ >= 0 && !filter_[index_]; --index_);
+            index_ = filter_ ? filter_->find_prev(index_ - 1) : index_ - 1;
             if (index_ == -1) return *this;
             Base::val_ = EdgeType(index_, mesh_);
             return *this;
@@ -249,14 +248,15 @@ template <int N> class Triangulation<2, N> : public TriangulationBase<2, N, Tria
     boundary_edge_iterator boundary_edges_end() const { return boundary_edge_iterator(n_edges_, this); }
 
     // point location
-    DVector<int> locate(const DMatrix<double>& points) const {
+    DVector<int> locate(const DMatrix<double>& points) const { return location_policy().locate(points); }
+    // the point location data structure, built on first access. Once built, it can be queried concurrently
+    const LocationPolicy& location_policy() const {
         if (!location_policy_.has_value()) location_policy_ = LocationPolicy(this);
-        return location_policy_->locate(points);
+        return location_policy_.value();
     }
     // the set of cells which have node id as vertex
     std::vector<int> node_patch(int id) const {
-        if (!location_policy_.has_value()) location_policy_ = LocationPolicy(this);
-        return location_policy_->all_locate(Base::node(id));
+        return location_policy().all_locate(Base::node(id));
     }
    protected:
     std::vector<int> edges_ {};                        // nodes (as row indexes in nodes_ matrix) composing each edge
@@ -276,30 +276,32 @@ template <> class Triangulation<3, 3> : public TriangulationBase<3, 3, Triangula
         using Base = index_based_iterator<Iterator, ValueType>;
         using Base::index_;
         const Triangulation* mesh_;
-        BinaryVector<fdapde::Dynamic> filter_;
-        void next_() {
-            for (; index_ < Base::end_ && !filter_[index_]; ++index_);
-            if (index_ == Base::end_) return;
+        const BinaryVector<fdapde::Dynamic>* filter_;   // non-owning view on the filter, nullptr visits all entities
+        void next_() {   // moves to the first entity passing the filter at position greater or equal than index_
+            if (filter_) index_ = std::min(filter_->find_next(index_), Base::end_);
+            if (index_ >= Base::end_) return;
             Base::val_ = ValueType(index_, mesh_);
-            index_++;
         }
        public:
         iterator(
           int index, int begin, int end, const Triangulation* mesh, const BinaryVector<fdapde::Dynamic>& filter) :
-            Base(index, begin, end), mesh_(mesh), filter_(filter) {
+            Base(index, begin, end), mesh_(mesh), filter_(&filter) {
             next_();
         }
         iterator(int index, int begin, int end, const Triangulation* mesh) :
-            iterator(index, begin, end, mesh, BinaryVector<fdapde::Dynamic>::Ones(mesh->n_edges_)) { }
+            Base(index, begin, end), mesh_(mesh), filter_(nullptr) {
+            next_();
+        }
         Iterator& operator++() {
+            index_++;
             next_();
             return static_cast<Iterator&>(*this);
         }
         Iterator& operator--() {
-            for (; index_ >= Base::begin_ && !filter_[index_]; --index_);
-            if (index_ == -1) return static_cast<Iterator&>(*this);
-            Base::val_ = ValueType(index_, mesh_);
             index_--;
+            if (filter_) index_ = filter_->find_prev(index_);
+            if (index_ < Base::begin_) return static_cast<Iterator&>(*this);
+            Base::val_ = ValueType(index_, mesh_);
             return static_cast<Iterator&>(*this);
         }
     };
@@ -471,14 +473,15 @@ template <> class Triangulation<3, 3> : public TriangulationBase<3, 3, Triangula
     }
 
     // point location
-    DVector<int> locate(const DMatrix<double>& points) const {
+    DVector<int> locate(const DMatrix<double>& points) const { return location_policy().locate(points); }
+    // the point location data structure, built on first access. Once built, it can be queried concurrently
+    const LocationPolicy& location_policy() const {
         if (!location_policy_.has_value()) location_policy_ = LocationPolicy(this);
-        return location_policy_->locate(points);
+        return location_policy_.value();
     }
     // computes the set of elements which have node id as vertex
     std::vector<int> node_patch(int id) const {
-        if (!location_policy_.has_value()) location_policy_ = LocationPolicy(this);
-        return location_policy_->all_locate(Base::node(id));
+        return location_policy().all_locate(Base::node(id));
     }
    protected:
     std::vector<int> faces_, edges_;   // nodes (as row indexes in nodes_ matrix) composing each face and edge
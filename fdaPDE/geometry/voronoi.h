@@ -21,6 +21,7 @@
 #include <unordered_set>
 
 #include "../utils/symbols.h"
+#include "cell_traversal.h"
 #include "utils.h"
 
 #include <unsupported/Eigen/SparseExtra>
@@ -43,21 +44,23 @@ template <> class Voronoi<Triangulation<2, 2>> {
         nodes_.resize(n_delaunay_faces + n_delaunay_boundary_edges + mesh_->n_boundary_nodes(), embed_dim);
         nodes_markers_.resize(nodes_.rows());
         int k = n_delaunay_faces;
-        for (typename Triangulation<2, 2>::cell_iterator it = mesh_->cells_begin(); it != mesh_->cells_end(); ++it) {
-            nodes_.row(it->id()) = it->circumcenter();
-            for (int v : it->node_ids()) { cells_[v].push_back(it->id()); }
-            if (it->on_boundary()) {
-                for (typename Triangulation<2, 2>::CellType::edge_iterator jt = it->edges_begin();
-                     jt != it->edges_end(); ++jt) {
+        // voronoi nodes are the circumcenters of delaunay cells
+        using CellType = typename Triangulation<2, 2>::CellType;
+        for_each_cell(*mesh_, [&](const CellType& e) { nodes_.row(e.id()) = e.circumcenter(); });
+        // build cells and nodes on boundary edges (sequential, node numbering depends on the visit order)
+        for_each_cell(*mesh_, execution::seq, [&](const CellType& e) {
+            for (int v : e.node_ids()) { cells_[v].push_back(e.id()); }
+            if (e.on_boundary()) {
+                for (typename CellType::edge_iterator jt = e.edges_begin(); jt != e.edges_end(); ++jt) {
                     if (jt->on_boundary()) {
-                        nodes_.row(k) = jt->supporting_plane().project(nodes_.row(it->id()));
+                        nodes_.row(k) = jt->supporting_plane().project(nodes_.row(e.id()));
                         nodes_markers_.set(k);
                         for (int v : jt->node_ids()) { cells_[v].push_back(k); }
                         k++;
                     }
                 }
             }
-        }
+        });
         // augment node set with boundary vertices, sort each cell clockwise (around its mean point)
         for (auto& [key, value] : cells_) {
             if (mesh_->is_node_on_boundary(key)) {
@@ -204,20 +207,23 @@ template <> class Voronoi<Triangulation<1, 1>> {
         nodes_.resize(n_delaunay_faces + 2, embed_dim);
         nodes_markers_.resize(nodes_.rows());
         int k = n_delaunay_faces;
-        for (typename Triangulation<1, 1>::cell_iterator it = mesh_->cells_begin(); it != mesh_->cells_end(); ++it) {
-            nodes_.row(it->id()) = it->circumcenter();
-            for (int v : it->node_ids()) { cells_[v].push_back(it->id()); }
-            if (it->on_boundary()) {
+        // voronoi nodes are the circumcenters of delaunay cells
+        using CellType = typename Triangulation<1, 1>::CellType;
+        for_each_cell(*mesh_, [&](const CellType& e) { nodes_.row(e.id()) = e.circumcenter(); });
+        // build cells and boundary nodes (sequential, node numbering depends on the visit order)
+        for_each_cell(*mesh_, execution::seq, [&](const CellType& e) {
+            for (int v : e.node_ids()) { cells_[v].push_back(e.id()); }
+            if (e.on_boundary()) {
                 for (int i = 0; i < Triangulation<1, 1>::n_nodes_per_cell; ++i) {
-                    if (mesh_->is_node_on_boundary(it->node_ids()[i])) {
-                        nodes_.row(k) = mesh_->node(it->node_ids()[i]);
+                    if (mesh_->is_node_on_boundary(e.node_ids()[i])) {
+                        nodes_.row(k) = mesh_->node(e.node_ids()[i]);
                         nodes_markers_.set(k);
-                        cells_[it->node_ids()[i]].push_back(k);
+                        cells_[e.node_ids()[i]].push_back(k);
                         k++;
                     }
                 }
             }
-        }
+        });
         // sort each cell clockwise (around its mean point)
         for (auto& [key, value] : cells_) {
             if (value[1] < value[0]) std::swap(value[0], value[1]);
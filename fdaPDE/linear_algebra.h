@@ -21,6 +21,9 @@
 #include "linear_algebra/kronecker_product.h"
 #include "linear_algebra/smw.h"
 #include "linear_algebra/sparse_block_matrix.h"
+#include "linear_algebra/krylov_solvers.h"
+#include "linear_algebra/fspai.h"
 #include "linear_algebra/lumping.h"
+#include "linear_algebra/banded_lu.h"
 
 #endif   // __FDAPDE_LINEAR_ALGEBRA_MODULE_H__
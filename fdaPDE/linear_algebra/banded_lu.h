@@ -0,0 +1,133 @@
+// This file is part of fdaPDE, a C++ library for physics-informed
+// spatial and functional data analysis.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __BANDED_LU_H__
+#define __BANDED_LU_H__
+
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "../utils/assert.h"
+#include "../utils/symbols.h"
+
+namespace fdapde {
+namespace core {
+
+// LU factorization with partial pivoting of a banded matrix A, having kl subdiagonals and ku superdiagonals. The factors
+// are stored in compact (LAPACK-like) band storage, with A(i, j) at position (kl + ku + i - j, j) of a (2kl+ku+1) x n
+// dense matrix (the kl extra rows hold the fill-in due to pivoting). Factorization costs O(n*kl*(kl+ku)), each solve
+// O(n*(2kl+ku)), memory is O(n*(2kl+ku))
+template <typename Scalar_ = double> class BandedLU {
+   private:
+    DMatrix<Scalar_> ab_ {};    // band storage of L and U factors
+    std::vector<int> ipiv_ {};  // row interchanges, row j has been swapped with row ipiv_[j]
+    int n_ = 0, kl_ = 0, ku_ = 0;
+    Eigen::ComputationInfo info_ = Eigen::InvalidInput;
+   public:
+    BandedLU() = default;
+    template <typename ExprType> explicit BandedLU(const Eigen::SparseMatrixBase<ExprType>& A) { compute(A); }
+
+    // factorizes a sparse matrix, bandwidths are deduced from its sparsity pattern
+    template <typename ExprType> BandedLU& compute(const Eigen::SparseMatrixBase<ExprType>& A) {
+        fdapde_assert(A.rows() == A.cols());
+        SpMatrix<Scalar_> A_ = A;
+        n_ = A_.rows();
+        kl_ = 0;
+        ku_ = 0;
+        for (int k = 0; k < A_.outerSize(); ++k) {
+            for (typename SpMatrix<Scalar_>::InnerIterator it(A_, k); it; ++it) {
+                kl_ = std::max(kl_, static_cast<int>(it.row() - it.col()));
+                ku_ = std::max(ku_, static_cast<int>(it.col() - it.row()));
+            }
+        }
+        int kv = kl_ + ku_;
+        ab_ = DMatrix<Scalar_>::Zero(2 * kl_ + ku_ + 1, n_);
+        for (int k = 0; k < A_.outerSize(); ++k) {
+            for (typename SpMatrix<Scalar_>::InnerIterator it(A_, k); it; ++it) {
+                ab_(kv + it.row() - it.col(), it.col()) = it.value();
+            }
+        }
+        factorize_();
+        return *this;
+    }
+    // solves A*x = b, for each column of b
+    template <typename RhsType> DMatrix<Scalar_> solve(const Eigen::MatrixBase<RhsType>& b) const {
+        fdapde_assert(info_ == Eigen::Success && b.rows() == n_);
+        DMatrix<Scalar_> x = b;
+        int kv = kl_ + ku_;
+        for (int c = 0; c < x.cols(); ++c) {
+            // forward substitution L*y = P*b
+            for (int j = 0; j < n_ - 1; ++j) {
+                int km = std::min(kl_, n_ - 1 - j);
+                if (ipiv_[j] != j) std::swap(x(j, c), x(ipiv_[j], c));
+                for (int p = 1; p <= km; ++p) { x(j + p, c) -= ab_(kv + p, j) * x(j, c); }
+            }
+            // backward substitution U*x = y, U has kl + ku superdiagonals
+            for (int j = n_ - 1; j >= 0; --j) {
+                x(j, c) /= ab_(kv, j);
+                for (int i = std::max(0, j - kv); i < j; ++i) { x(i, c) -= ab_(kv + i - j, j) * x(j, c); }
+            }
+        }
+        return x;
+    }
+    Eigen::ComputationInfo info() const { return info_; }
+    int rows() const { return n_; }
+    int cols() const { return n_; }
+    int lower_bandwidth() const { return kl_; }
+    int upper_bandwidth() const { return ku_; }
+   private:
+    // in place unblocked band LU factorization (as LAPACK's gbtf2)
+    void factorize_() {
+        int kv = kl_ + ku_;
+        ipiv_.resize(n_);
+        info_ = Eigen::Success;
+        int ju = 0;   // index of the last column affected by the current row interchanges
+        for (int j = 0; j < n_; ++j) {
+            int km = std::min(kl_, n_ - 1 - j);
+            // find pivot in column j
+            int jp = 0;
+            for (int p = 1; p <= km; ++p) {
+                if (std::abs(ab_(kv + p, j)) > std::abs(ab_(kv + jp, j))) jp = p;
+            }
+            ipiv_[j] = j + jp;
+            if (ab_(kv + jp, j) == Scalar_(0)) {   // singular matrix
+                info_ = Eigen::NumericalIssue;
+                return;
+            }
+            ju = std::max(ju, std::min(j + ku_ + jp, n_ - 1));
+            if (jp != 0) {   // swap rows j and j + jp in columns j, ..., ju
+                for (int d = 0; d <= ju - j; ++d) { std::swap(ab_(kv + jp - d, j + d), ab_(kv - d, j + d)); }
+            }
+            if (km > 0) {
+                for (int p = 1; p <= km; ++p) { ab_(kv + p, j) /= ab_(kv, j); }
+                // rank-one update of the trailing submatrix
+                for (int d = 1; d <= ju - j; ++d) {
+                    Scalar_ u = ab_(kv - d, j + d);
+                    if (u == Scalar_(0)) continue;
+                    for (int p = 1; p <= km; ++p) { ab_(kv + p - d, j + d) -= ab_(kv + p, j) * u; }
+                }
+            }
+        }
+    }
+};
+
+}   // namespace core
+}   // namespace fdapde
+
+#endif   // __BANDED_LU_H__
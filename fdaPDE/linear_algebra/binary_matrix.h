@@ -20,6 +20,8 @@
 #include "../utils/assert.h"
 #include "../utils/symbols.h"
 
+#include <algorithm>
+#include <bit>
 #include <bitset>
 
 namespace fdapde {
@@ -428,13 +430,6 @@ template <typename XprType> struct any_visitor {
     inline void apply(BitPackType b, int size) { res |= (((~(BitPackType)0 >> (PackSize - size)) & b) != 0); }
     operator bool() const { return res == true; }   // stop if already true
 };
-// counts the number of true coefficients in a binary expression
-template <typename XprType> struct count_visitor {
-    int res = 0;
-    inline void apply(bool b) {
-        if (b) res++;
-    }
-};
   
 // a non-writable expression of a block-repeat operation
 template <int Rows, int Cols, typename XprTypeNested>
@@ -523,6 +518,10 @@ template <int Rows, int Cols, typename XprType> class BinMtxBase {
     // returns all the indices (in row-major order) having coefficients equal to b
     std::vector<int> which(bool b) const {
         std::vector<int> result;
+        if (b) {   // jump from one set bit to the next
+            for (int i = find_next(0); i < size(); i = find_next(i + 1)) { result.push_back(i); }
+            return result;
+        }
         for (int i = 0; i < n_rows_; ++i) {
             for (int j = 0; j < n_cols_; ++j) {
                 if (get()(i, j) == b) result.push_back(i * n_cols_ + j);
@@ -532,6 +531,32 @@ template <int Rows, int Cols, typename XprType> class BinMtxBase {
     }
     // access to i-th bitpack of the expression
     BitPackType bitpack(int i) const { return get().bitpack(i); }
+    // index (in row-major order) of the first true coefficient at position greater or equal than i, size() if none.
+    // bitpacks are scanned one word at a time, locating set bits with count-trailing-zeros
+    int find_next(int i) const {
+        int n = size();
+        if (i < 0) i = 0;
+        if (i >= n) return n;
+        int k = i / PackSize;
+        BitPackType b = get().bitpack(k) & (~BitPackType(0) << (i % PackSize));   // discard bits before i
+        while (!b) {
+            if (++k * PackSize >= n) return n;
+            b = get().bitpack(k);
+        }
+        return std::min(k * PackSize + std::countr_zero(b), n);
+    }
+    // index (in row-major order) of the last true coefficient at position less or equal than i, -1 if none
+    int find_prev(int i) const {
+        if (i >= size()) i = size() - 1;
+        if (i < 0) return -1;
+        int k = i / PackSize;
+        BitPackType b = get().bitpack(k) & (~BitPackType(0) >> (PackSize - 1 - i % PackSize));   // discard bits after i
+        while (!b) {
+            if (--k < 0) return -1;
+            b = get().bitpack(k);
+        }
+        return k * PackSize + PackSize - 1 - std::countl_zero(b);
+    }
     // send matrix to out stream
     friend std::ostream& operator<<(std::ostream& out, const BinMtxBase& m) {
         // assign to temporary (triggers fast bitwise evaluation)
@@ -576,7 +601,14 @@ template <int Rows, int Cols, typename XprType> class BinMtxBase {
     // visitors support
     inline bool all() const { return visit_apply_<all_visitor<XprType>, linear_bitpack_visit>(); }
     inline bool any() const { return visit_apply_<any_visitor<XprType>, linear_bitpack_visit>(); }
-    inline int count() const { return visit_apply_<count_visitor<XprType>, linear_bit_visit>(); }
+    inline int count() const {   // word-wise population count, padding bits of the last bitpack are masked out
+        int n = size(), res = 0, k = 0;
+        for (; (k + 1) * PackSize <= n; ++k) { res += std::popcount(get().bitpack(k)); }
+        if (k * PackSize < n) {
+            res += std::popcount(get().bitpack(k) & (~BitPackType(0) >> ((k + 1) * PackSize - n)));
+        }
+        return res;
+    }
     // selection on eigen expressions
     template <typename ExprType>
     DMatrix<typename ExprType::Scalar> select(const Eigen::MatrixBase<ExprType>& mtx) const {
@@ -18,9 +18,30 @@
 #define __KRONECKER_PRODUCT_H__
 
 #include <Eigen/Core>
+#include <Eigen/Sparse>
+#include <thread>
 #include <type_traits>
 
+#include "../multithreading/parallel_for.h"
+#include "../utils/assert.h"
+#include "../utils/symbols.h"
+
 namespace fdapde {
+namespace internals {
+
+// returns m in compressed storage, copying it in buff only if required
+template <typename SpMatrixType, typename XprType>
+const SpMatrixType& compressed_storage(const Eigen::SparseMatrixBase<XprType>& m, SpMatrixType& buff) {
+    if constexpr (std::is_same<XprType, SpMatrixType>::value) {
+        if (m.derived().isCompressed()) return m.derived();
+    }
+    buff = m.derived();
+    buff.makeCompressed();
+    return buff;
+}
+
+}   // namespace internals
+
 namespace core {
 
 // Eigen-compatible implementation of the Kronecker tensor product between matrices.
@@ -79,6 +100,126 @@ Kronecker(const Eigen::SparseMatrixBase<Lhs>& lhs, const Eigen::SparseMatrixBase
     return KroneckerTensorProduct<Lhs, Rhs, Eigen::Sparse, Eigen::Sparse>(lhs.derived(), rhs.derived());
 }
 
+// materializes A \kron B in compressed column storage. Column j*B.cols() + l of the result has exactly
+// nnz(A[,j])*nnz(B[,l]) nonzeros, hence the outer index is computed upfront and inner indexes and values are written in
+// place, in parallel over the columns of A. Inner indexes come out sorted, since both operands have sorted columns
+template <typename Lhs, typename Rhs, typename Scalar_, typename StorageIndex_>
+void kronecker_product_sparse(
+  const Eigen::SparseMatrixBase<Lhs>& lhs, const Eigen::SparseMatrixBase<Rhs>& rhs,
+  Eigen::SparseMatrix<Scalar_, Eigen::ColMajor, StorageIndex_>& dst,
+  int n_threads = std::thread::hardware_concurrency()) {
+    using SpMatrixType = Eigen::SparseMatrix<Scalar_, Eigen::ColMajor, StorageIndex_>;
+    SpMatrixType lhs_buff, rhs_buff;
+    const SpMatrixType& A = internals::compressed_storage(lhs, lhs_buff);
+    const SpMatrixType& B = internals::compressed_storage(rhs, rhs_buff);
+    const StorageIndex_ *Ap = A.outerIndexPtr(), *Ai = A.innerIndexPtr(), *Bp = B.outerIndexPtr(), *Bi = B.innerIndexPtr();
+    const Scalar_ *Av = A.valuePtr(), *Bv = B.valuePtr();
+    int n = A.cols(), q = B.cols();
+    StorageIndex_ m = B.rows();
+    // the result is built aside, since dst might alias one of the operands
+    SpMatrixType result(A.rows() * B.rows(), A.cols() * B.cols());
+    StorageIndex_* outer = result.outerIndexPtr();
+    outer[0] = 0;
+    for (int j = 0; j < n; ++j) {
+        for (int l = 0; l < q; ++l) {
+            outer[j * q + l + 1] = outer[j * q + l] + (Ap[j + 1] - Ap[j]) * (Bp[l + 1] - Bp[l]);
+        }
+    }
+    result.resizeNonZeros(outer[n * q]);
+    StorageIndex_* inner = result.innerIndexPtr();
+    Scalar_* values = result.valuePtr();
+    parallel_for_chunks(n, n_parallel_chunks(n, 16, n_threads), [&](int begin, int end, int) {
+        for (int j = begin; j < end; ++j) {
+            for (int l = 0; l < q; ++l) {   // column j*q + l is the block A[,j] \kron B[,l]
+                StorageIndex_ pos = outer[j * q + l];
+                for (StorageIndex_ a = Ap[j]; a < Ap[j + 1]; ++a) {
+                    for (StorageIndex_ b = Bp[l]; b < Bp[l + 1]; ++b, ++pos) {
+                        inner[pos] = Ai[a] * m + Bi[b];
+                        values[pos] = Av[a] * Bv[b];
+                    }
+                }
+            }
+        }
+    });
+    dst.swap(result);
+}
+
+// computes (A \kron B)*x without materializing A \kron B, exploiting the identity (A \kron B)vec(X) = vec(B*X*A^\top),
+// being X = reshape(x, B.cols(), A.cols()). Costs O(nnz(A)*B.rows() + nnz(B)*A.cols()) for each column of x
+template <typename Lhs, typename Rhs, typename XType>
+DMatrix<typename XType::Scalar> kronecker_matvec(const Lhs& A, const Rhs& B, const Eigen::MatrixBase<XType>& x) {
+    using Scalar_ = typename XType::Scalar;
+    fdapde_assert(x.rows() == A.cols() * B.cols());
+    DMatrix<Scalar_> y(A.rows() * B.rows(), x.cols());
+    DVector<Scalar_> x_k;
+    DMatrix<Scalar_> BX;
+    for (int k = 0; k < x.cols(); ++k) {
+        x_k = x.col(k);
+        Eigen::Map<const DMatrix<Scalar_>> X(x_k.data(), B.cols(), A.cols());
+        Eigen::Map<DMatrix<Scalar_>> Y(y.col(k).data(), B.rows(), A.rows());
+        BX.noalias() = B * X;
+        Y.noalias() = BX * A.transpose();
+    }
+    return y;
+}
+
+// product of a Kronecker expression with a dense matrix, evaluated by kronecker_matvec
+template <typename Lhs, typename Rhs, typename LhsStorageKind, typename RhsStorageKind, typename XType>
+DMatrix<typename XType::Scalar> operator*(
+  const KroneckerTensorProduct<Lhs, Rhs, LhsStorageKind, RhsStorageKind>& kron, const Eigen::MatrixBase<XType>& x) {
+    return kronecker_matvec(kron.lhs_, kron.rhs_, x);
+}
+
+// solver for linear systems (A \kron B)x = b. Since (A \kron B)^{-1} = A^{-1} \kron B^{-1}, A and B are factorized
+// separately and x = vec(B^{-1}*X*A^{-\top}), being X = reshape(b, B.rows(), A.rows()). LhsSolver and RhsSolver can be
+// any Eigen solver (e.g. Eigen::SparseLU, Eigen::PartialPivLU) exposing the compute(), solve() and info() interface
+template <typename LhsSolver, typename RhsSolver = LhsSolver> class KroneckerSolver {
+   private:
+    LhsSolver lhs_solver_;   // factorization of A
+    RhsSolver rhs_solver_;   // factorization of B
+    int lhs_size_ = 0, rhs_size_ = 0;
+   public:
+    using Scalar = typename LhsSolver::Scalar;
+    KroneckerSolver() = default;
+    template <typename Lhs, typename Rhs> KroneckerSolver(const Lhs& A, const Rhs& B) { compute(A, B); }
+    template <typename Lhs, typename Rhs, typename LhsStorageKind, typename RhsStorageKind>
+    explicit KroneckerSolver(const KroneckerTensorProduct<Lhs, Rhs, LhsStorageKind, RhsStorageKind>& kron) {
+        compute(kron.lhs_, kron.rhs_);
+    }
+    // factorizes A and B
+    template <typename Lhs, typename Rhs> KroneckerSolver& compute(const Lhs& A, const Rhs& B) {
+        fdapde_assert(A.rows() == A.cols() && B.rows() == B.cols());
+        lhs_solver_.compute(A);
+        rhs_solver_.compute(B);
+        lhs_size_ = A.rows();
+        rhs_size_ = B.rows();
+        return *this;
+    }
+    template <typename Lhs, typename Rhs, typename LhsStorageKind, typename RhsStorageKind>
+    KroneckerSolver& compute(const KroneckerTensorProduct<Lhs, Rhs, LhsStorageKind, RhsStorageKind>& kron) {
+        return compute(kron.lhs_, kron.rhs_);
+    }
+    // solves (A \kron B)x = b, for each column of b
+    template <typename BType> DMatrix<Scalar> solve(const Eigen::MatrixBase<BType>& b) const {
+        fdapde_assert(b.rows() == lhs_size_ * rhs_size_);
+        DMatrix<Scalar> x(b.rows(), b.cols());
+        DVector<Scalar> b_k;
+        DMatrix<Scalar> Y;
+        for (int k = 0; k < b.cols(); ++k) {
+            b_k = b.col(k);
+            Eigen::Map<const DMatrix<Scalar>> X(b_k.data(), rhs_size_, lhs_size_);
+            Y = rhs_solver_.solve(X);   // B^{-1}*X
+            Eigen::Map<DMatrix<Scalar>>(x.col(k).data(), rhs_size_, lhs_size_) =
+              lhs_solver_.solve(DMatrix<Scalar>(Y.transpose())).transpose();   // (A^{-1}*(B^{-1}*X)^\top)^\top
+        }
+        return x;
+    }
+    Eigen::ComputationInfo info() const {
+        return (lhs_solver_.info() == Eigen::Success && rhs_solver_.info() == Eigen::Success) ? Eigen::Success :
+                                                                                               Eigen::NumericalIssue;
+    }
+};
+
 }   // namespace core
 }   // namespace fdapde
 
@@ -249,6 +390,20 @@ class evaluator<KroneckerTensorProduct<Lhs_, Rhs_, Sparse, Sparse>> :
     const XprType& xpr_;
 };
 
+// dst = Kronecker(lhs, rhs) for sparse operands and column major sparse dst, dispatched to kronecker_product_sparse
+template <typename DstXprType, typename Lhs, typename Rhs, typename Scalar>
+struct Assignment<DstXprType, KroneckerTensorProduct<Lhs, Rhs, Sparse, Sparse>, assign_op<Scalar, Scalar>, Sparse2Sparse> {
+    typedef KroneckerTensorProduct<Lhs, Rhs, Sparse, Sparse> SrcXprType;
+    static void run(DstXprType& dst, const SrcXprType& src, const assign_op<Scalar, Scalar>&) {
+        if constexpr (std::is_same<
+                        DstXprType, SparseMatrix<Scalar, ColMajor, typename DstXprType::StorageIndex>>::value) {
+            fdapde::core::kronecker_product_sparse(src.lhs_, src.rhs_, dst);
+        } else {
+            assign_sparse_to_sparse(dst.derived(), src);
+        }
+    }
+};
+
 }   // namespace internal
 }   // namespace Eigen
 
@@ -0,0 +1,289 @@
+// This file is part of fdaPDE, a C++ library for physics-informed
+// spatial and functional data analysis.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __KRYLOV_SOLVERS_H__
+#define __KRYLOV_SOLVERS_H__
+
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+#include <cmath>
+#include <vector>
+
+#include "../utils/assert.h"
+#include "../utils/symbols.h"
+#include "sparse_block_matrix.h"
+
+namespace fdapde {
+namespace core {
+
+// Matrix-free Krylov solvers. MatrixType is only required to provide rows() and a product with a dense vector, hence
+// structured operators (SparseBlockMatrix, Kronecker expressions) are never assembled. A Preconditioner exposes
+// compute(const MatrixType&) and solve(const DVector<double>&), returning the application of P^{-1}
+
+// no preconditioning
+struct IdentityPreconditioner {
+    template <typename MatrixType> IdentityPreconditioner& compute(const MatrixType&) { return *this; }
+    DVector<double> solve(const DVector<double>& r) const { return r; }
+};
+
+// preconditioners for saddle point systems K = [A B^\top; B -C], stored as 2x2 SparseBlockMatrix. Both use the
+// approximation S = C + B*diag(A)^{-1}*B^\top of the Schur complement C + B*A^{-1}*B^\top, unless A and S are supplied
+class SaddlePointPreconditionerBase {
+   protected:
+    Eigen::SparseLU<SpMatrix<double>> A_solver_, S_solver_;   // factorizations of A and S
+    int n1_ = 0, n2_ = 0;                                       // size of the (1,1) and (2,2) blocks
+
+    void factorize_(const SpMatrix<double>& A, const SpMatrix<double>& S) {
+        fdapde_assert(A.rows() == A.cols() && S.rows() == S.cols());
+        n1_ = A.rows();
+        n2_ = S.rows();
+        A_solver_.compute(A);
+        S_solver_.compute(S);
+    }
+    void factorize_(const SparseBlockMatrix<double, 2, 2>& K) {
+        DVector<double> inv_diag_A = K.block(0, 0).diagonal();
+        for (int i = 0; i < inv_diag_A.rows(); ++i) { inv_diag_A[i] = inv_diag_A[i] != 0 ? 1.0 / inv_diag_A[i] : 0.0; }
+        SpMatrix<double> S = -K.block(1, 1) + SpMatrix<double>(K.block(1, 0) * inv_diag_A.asDiagonal() * K.block(0, 1));
+        factorize_(K.block(0, 0), S);
+    }
+   public:
+    Eigen::ComputationInfo info() const {
+        return (A_solver_.info() == Eigen::Success && S_solver_.info() == Eigen::Success) ? Eigen::Success :
+                                                                                           Eigen::NumericalIssue;
+    }
+};
+
+// block diagonal preconditioner P = diag(A, S). P is symmetric positive definite if A and S are, as required by MINRES
+class BlockDiagonalPreconditioner : public SaddlePointPreconditionerBase {
+   public:
+    BlockDiagonalPreconditioner& compute(const SparseBlockMatrix<double, 2, 2>& K) {
+        factorize_(K);
+        return *this;
+    }
+    BlockDiagonalPreconditioner& compute(const SpMatrix<double>& A, const SpMatrix<double>& S) {
+        factorize_(A, S);
+        return *this;
+    }
+    DVector<double> solve(const DVector<double>& r) const {
+        fdapde_assert(r.rows() == n1_ + n2_);
+        DVector<double> z(r.rows());
+        z.head(n1_) = A_solver_.solve(r.head(n1_));
+        z.tail(n2_) = S_solver_.solve(r.tail(n2_));
+        return z;
+    }
+};
+
+// block upper triangular (Schur complement) preconditioner P = [A B^\top; 0 -S]. P is not symmetric, use with GMRES.
+// If S is the exact Schur complement, GMRES converges in two iterations
+class SchurComplementPreconditioner : public SaddlePointPreconditionerBase {
+   private:
+    SpMatrix<double> Bt_;   // (1,2) block of K
+   public:
+    SchurComplementPreconditioner& compute(const SparseBlockMatrix<double, 2, 2>& K) {
+        Bt_ = K.block(0, 1);
+        factorize_(K);
+        return *this;
+    }
+    SchurComplementPreconditioner&
+    compute(const SpMatrix<double>& A, const SpMatrix<double>& Bt, const SpMatrix<double>& S) {
+        Bt_ = Bt;
+        factorize_(A, S);
+        return *this;
+    }
+    DVector<double> solve(const DVector<double>& r) const {
+        fdapde_assert(r.rows() == n1_ + n2_);
+        DVector<double> z(r.rows());
+        z.tail(n2_) = -S_solver_.solve(r.tail(n2_));
+        z.head(n1_) = A_solver_.solve(r.head(n1_) - Bt_ * z.tail(n2_));
+        return z;
+    }
+};
+
+// common interface of iterative solvers (Eigen naming conventions)
+template <typename MatrixType, typename Preconditioner> class KrylovSolverBase {
+   protected:
+    const MatrixType* mat_ = nullptr;
+    Preconditioner preconditioner_ {};
+    double tol_ = 1e-10;   // relative tolerance on the residual norm
+    int max_iter_ = -1;    // defaulted to twice the size of the system
+    mutable int iterations_ = 0;
+    mutable double error_ = 0;   // relative residual norm at exit
+    mutable Eigen::ComputationInfo info_ = Eigen::InvalidInput;
+    int max_iterations_() const { return max_iter_ < 0 ? 2 * mat_->rows() : max_iter_; }
+   public:
+    KrylovSolverBase() = default;
+    // sets the system matrix and computes the preconditioner
+    void compute(const MatrixType& mat) {
+        mat_ = &mat;
+        preconditioner_.compute(mat);
+    }
+    // sets the system matrix, the preconditioner must be computed by the caller (e.g. to supply A and S explicitly)
+    void analyzePattern(const MatrixType& mat) { mat_ = &mat; }
+    Preconditioner& preconditioner() { return preconditioner_; }
+    void setTolerance(double tol) { tol_ = tol; }
+    void setMaxIterations(int max_iter) { max_iter_ = max_iter; }
+    double tolerance() const { return tol_; }
+    int iterations() const { return iterations_; }
+    double error() const { return error_; }
+    Eigen::ComputationInfo info() const { return info_; }
+};
+
+// preconditioned MINRES for symmetric (possibly indefinite) systems, with a symmetric positive definite preconditioner
+// (Paige, C. C., & Saunders, M. A. (1975), as in Elman, H., Silvester, D., & Wathen, A. (2014), Algorithm 2.4). Stops when
+// the preconditioned residual norm, reduced by the initial one, drops below the tolerance
+template <typename MatrixType, typename Preconditioner = IdentityPreconditioner>
+class MINRES : public KrylovSolverBase<MatrixType, Preconditioner> {
+    using Base = KrylovSolverBase<MatrixType, Preconditioner>;
+    using Base::mat_;
+    using Base::preconditioner_;
+   public:
+    MINRES() = default;
+    MINRES(const MatrixType& mat) { Base::compute(mat); }
+
+    DVector<double> solve(const DVector<double>& b) const { return solve(b, DVector<double>::Zero(b.rows())); }
+    DVector<double> solve(const DVector<double>& b, const DVector<double>& x0) const {
+        fdapde_assert(mat_ != nullptr && b.rows() == mat_->rows());
+        DVector<double> x = x0;
+        DVector<double> v_old = DVector<double>::Zero(b.rows()), v = b - (*mat_) * x;
+        DVector<double> z = preconditioner_.solve(v);
+        DVector<double> w_old = DVector<double>::Zero(b.rows()), w = w_old, w_new, v_new, z_new, Az;
+        double gamma_old = 1, gamma = std::sqrt(z.dot(v));
+        double eta = gamma, eta0 = gamma;
+        double s_old = 0, s = 0, c_old = 1, c = 1;
+        this->iterations_ = 0;
+        this->error_ = 0;
+        this->info_ = Eigen::Success;
+        if (eta0 == 0) return x;   // x0 solves the system
+        for (int j = 0; j < this->max_iterations_(); ++j) {
+            z /= gamma;
+            Az = (*mat_) * z;
+            double delta = Az.dot(z);
+            // Lanczos step
+            v_new = Az - (delta / gamma) * v - (gamma / gamma_old) * v_old;
+            z_new = preconditioner_.solve(v_new);
+            double gamma_new = std::sqrt(std::max(z_new.dot(v_new), 0.0));
+            // QR decomposition of the tridiagonal Lanczos matrix via Givens rotations
+            double alpha0 = c * delta - c_old * s * gamma;
+            double alpha1 = std::sqrt(alpha0 * alpha0 + gamma_new * gamma_new);
+            double alpha2 = s * delta + c_old * c * gamma;
+            double alpha3 = s_old * gamma;
+            double c_new = alpha0 / alpha1, s_new = gamma_new / alpha1;
+            // update solution
+            w_new = (z - alpha3 * w_old - alpha2 * w) / alpha1;
+            x += c_new * eta * w_new;
+            eta = -s_new * eta;
+            this->iterations_ = j + 1;
+            this->error_ = std::abs(eta) / eta0;
+            if (this->error_ < this->tol_ || gamma_new == 0) return x;
+            // shift Lanczos vectors and rotations
+            std::swap(v_old, v);
+            std::swap(v, v_new);
+            std::swap(z, z_new);
+            std::swap(w_old, w);
+            std::swap(w, w_new);
+            gamma_old = gamma;
+            gamma = gamma_new;
+            c_old = c;
+            c = c_new;
+            s_old = s;
+            s = s_new;
+        }
+        this->info_ = Eigen::NoConvergence;
+        return x;
+    }
+};
+
+// right-preconditioned restarted GMRES for general systems (Saad, Y., & Schultz, M. H. (1986)). Right preconditioning
+// leaves the residual unchanged, stops when ||b - A*x||/||b|| drops below the tolerance
+template <typename MatrixType, typename Preconditioner = IdentityPreconditioner>
+class GMRES : public KrylovSolverBase<MatrixType, Preconditioner> {
+    using Base = KrylovSolverBase<MatrixType, Preconditioner>;
+    using Base::mat_;
+    using Base::preconditioner_;
+    int restart_ = 30;   // Krylov subspace dimension before restarting
+   public:
+    GMRES() = default;
+    GMRES(const MatrixType& mat) { Base::compute(mat); }
+    void set_restart(int restart) { restart_ = restart; }
+
+    DVector<double> solve(const DVector<double>& b) const { return solve(b, DVector<double>::Zero(b.rows())); }
+    DVector<double> solve(const DVector<double>& b, const DVector<double>& x0) const {
+        fdapde_assert(mat_ != nullptr && b.rows() == mat_->rows());
+        int n = b.rows(), m = std::min(restart_, n);
+        DVector<double> x = x0;
+        DMatrix<double> V(n, m + 1), H = DMatrix<double>::Zero(m + 1, m);   // Arnoldi basis and Hessenberg matrix
+        DVector<double> cs(m), sn(m), g(m + 1), w;
+        double b_norm = b.norm();
+        if (b_norm == 0) b_norm = 1;
+        this->iterations_ = 0;
+        this->info_ = Eigen::NoConvergence;
+        while (this->iterations_ < this->max_iterations_()) {
+            DVector<double> r = b - (*mat_) * x;
+            double beta = r.norm();
+            this->error_ = beta / b_norm;
+            if (this->error_ < this->tol_) {
+                this->info_ = Eigen::Success;
+                return x;
+            }
+            V.col(0) = r / beta;
+            g.setZero();
+            g[0] = beta;
+            int k = 0;
+            for (; k < m && this->iterations_ < this->max_iterations_(); ++k) {
+                w = (*mat_) * preconditioner_.solve(V.col(k));
+                // modified Gram-Schmidt orthogonalization
+                for (int i = 0; i <= k; ++i) {
+                    H(i, k) = V.col(i).dot(w);
+                    w -= H(i, k) * V.col(i);
+                }
+                H(k + 1, k) = w.norm();
+                if (H(k + 1, k) != 0) V.col(k + 1) = w / H(k + 1, k);
+                // apply previous Givens rotations to the new column of H, then compute the k-th one
+                for (int i = 0; i < k; ++i) {
+                    double tmp = cs[i] * H(i, k) + sn[i] * H(i + 1, k);
+                    H(i + 1, k) = -sn[i] * H(i, k) + cs[i] * H(i + 1, k);
+                    H(i, k) = tmp;
+                }
+                double rho = std::hypot(H(k, k), H(k + 1, k));
+                cs[k] = H(k, k) / rho;
+                sn[k] = H(k + 1, k) / rho;
+                H(k, k) = rho;
+                H(k + 1, k) = 0;
+                g[k + 1] = -sn[k] * g[k];
+                g[k] = cs[k] * g[k];
+                this->iterations_++;
+                this->error_ = std::abs(g[k + 1]) / b_norm;
+                if (this->error_ < this->tol_ || H(k, k) == 0) {
+                    ++k;
+                    break;
+                }
+            }
+            // x = x + P^{-1}*V*y, being y the solution of the upper triangular system H*y = g
+            DVector<double> y = H.topLeftCorner(k, k).triangularView<Eigen::Upper>().solve(g.head(k));
+            x += preconditioner_.solve(V.leftCols(k) * y);
+            if (this->error_ < this->tol_) {
+                this->info_ = Eigen::Success;
+                return x;
+            }
+        }
+        return x;
+    }
+};
+
+}   // namespace core
+}   // namespace fdapde
+
+#endif   // __KRYLOV_SOLVERS_H__
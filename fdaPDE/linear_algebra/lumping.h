@@ -24,21 +24,67 @@
 #include "../utils/symbols.h"
 
 namespace fdapde {
+namespace internals {
+
+// builds the diagonal sparse matrix having d as diagonal, writing the compressed storage directly
+template <typename Scalar_> SpMatrix<Scalar_> sparse_diagonal(const DVector<Scalar_>& d) {
+    int n = d.rows();
+    SpMatrix<Scalar_> diag(n, n);
+    diag.resizeNonZeros(n);
+    for (int i = 0; i < n; ++i) {
+        diag.outerIndexPtr()[i] = i;
+        diag.innerIndexPtr()[i] = i;
+        diag.valuePtr()[i] = d[i];
+    }
+    diag.outerIndexPtr()[n] = n;
+    return diag;
+}
+
+}   // namespace internals
+
 namespace core {
 
-// returns the lumped matrix of a sparse expression. Implements a row-sum lumping operator
-template <typename ExprType> SpMatrix<typename ExprType::Scalar> lump(const Eigen::SparseMatrixBase<ExprType>& expr) {
+// returns the row sums of a sparse expression, computed in a single pass over its nonzeros
+template <typename ExprType> DVector<typename ExprType::Scalar> lumped_diagonal(
+  const Eigen::SparseMatrixBase<ExprType>& expr) {
     fdapde_assert(expr.rows() == expr.cols());   // stop if not square
     using Scalar_ = typename ExprType::Scalar;
-    // reserve space for triplets
-    std::vector<fdapde::Triplet<Scalar_>> triplet_list;
-    triplet_list.reserve(expr.rows());
-    for (int i = 0; i < expr.rows(); ++i) { triplet_list.emplace_back(i, i, expr.row(i).sum()); }
-    // matrix lumping
-    SpMatrix<Scalar_> lumped_matrix(expr.rows(), expr.rows());
-    lumped_matrix.setFromTriplets(triplet_list.begin(), triplet_list.end());
-    lumped_matrix.makeCompressed();
-    return lumped_matrix;
+    // evaluate expression only if not already a plain sparse object
+    const typename Eigen::internal::nested_eval<ExprType, 1>::type mat(expr.derived());
+    using MatType = typename std::decay<decltype(mat)>::type;
+    DVector<Scalar_> d = DVector<Scalar_>::Zero(expr.rows());
+    for (int k = 0; k < mat.outerSize(); ++k) {
+        for (typename MatType::InnerIterator it(mat, k); it; ++it) { d[it.row()] += it.value(); }
+    }
+    return d;
+}
+// row sums of a symmetric matrix of which only the UpLo triangular part is stored. each stored off-diagonal entry
+// contributes to both its row and column
+template <typename MatrixType, unsigned int UpLo>
+DVector<typename MatrixType::Scalar> lumped_diagonal(const Eigen::SparseSelfAdjointView<MatrixType, UpLo>& expr) {
+    fdapde_assert(expr.rows() == expr.cols());   // stop if not square
+    using Scalar_ = typename MatrixType::Scalar;
+    using MatType = typename std::decay<MatrixType>::type;
+    const MatType& mat = expr.matrix();
+    DVector<Scalar_> d = DVector<Scalar_>::Zero(expr.rows());
+    for (int k = 0; k < mat.outerSize(); ++k) {
+        for (typename MatType::InnerIterator it(mat, k); it; ++it) {
+            int i = it.row(), j = it.col();
+            if ((UpLo & Eigen::Upper) ? i > j : i < j) continue;   // entry outside the referenced triangle
+            d[i] += it.value();
+            if (i != j) d[j] += it.value();
+        }
+    }
+    return d;
+}
+
+// returns the lumped matrix of a sparse expression. Implements a row-sum lumping operator
+template <typename ExprType> SpMatrix<typename ExprType::Scalar> lump(const Eigen::SparseMatrixBase<ExprType>& expr) {
+    return internals::sparse_diagonal(lumped_diagonal(expr));
+}
+template <typename MatrixType, unsigned int UpLo>
+SpMatrix<typename MatrixType::Scalar> lump(const Eigen::SparseSelfAdjointView<MatrixType, UpLo>& expr) {
+    return internals::sparse_diagonal(lumped_diagonal(expr));
 }
 
 // returns the lumped matrix of a dense expression. Implements a row-sum lumping operator
@@ -20,6 +20,7 @@
 #include <Eigen/LU>
 #include <Eigen/SparseLU>
 
+#include "../utils/assert.h"
 #include "../utils/symbols.h"
 
 namespace fdapde {
@@ -35,27 +36,49 @@ namespace core {
 // If A is sparse and C a small dense matrix, computing M^{-1} using the above decomposition is much more efficient
 // than computing M^{-1} directly
 
+// The factorization of A and the terms A^{-1}U and (C^{-1} + V*A^{-1}*U)^{-1}, which do not depend on the right hand side
+// b, are computed once by compute() and reused by any subsequent call to solve(). The solver for A must outlive this
+// object. Each solve() costs one sparse solve with A and one q x q dense solve, whatever the number of columns of b
 template <typename SparseSolver = fdapde::SparseLU<SpMatrix<double>>,
 	  typename DenseSolver  = Eigen::PartialPivLU<DMatrix<double>>>
-struct SMW {
+class SMW {
+   private:
+    const SparseSolver* invA_ = nullptr;
+    DMatrix<double> Y_;    // A^{-1}*U
+    DMatrix<double> V_;
+    DenseSolver invG_;     // factorization of G = C^{-1} + V*A^{-1}*U
+   public:
     // constructor
     SMW() = default;
+    SMW(const SparseSolver& invA, const DMatrix<double>& U, const DMatrix<double>& invC, const DMatrix<double>& V) {
+        compute(invA, U, invC, V);
+    }
 
-    // solves linear system (A + U*C^{-1}*V)x = b, assume to supply the already computed inversion of the dense matrix C
+    // prepares the solution of linear systems (A + U*C*V)x = b, assume to supply the already computed inversion of
+    // the dense matrix C
+    SMW& compute(
+      const SparseSolver& invA, const DMatrix<double>& U, const DMatrix<double>& invC, const DMatrix<double>& V) {
+        invA_ = &invA;
+        V_ = V;
+        // Y = A^{-1}U. Heavy step of the method. SMW is more and more efficient as q gets smaller and smaller
+        Y_ = invA.solve(U);
+        // compute dense matrix G = C^{-1} + V*A^{-1}*U = C^{-1} + V*Y
+        invG_.compute(invC + V * Y_);   // factorize qxq dense matrix G
+        return *this;
+    }
+    // solves linear system (A + U*C*V)x = b, for each column of b
+    DMatrix<double> solve(const DMatrix<double>& b) const {
+        fdapde_assert(invA_ != nullptr);
+        DMatrix<double> y = invA_->solve(b);   // y = A^{-1}b
+        DMatrix<double> t = invG_.solve(V_ * y);
+        // A^{-1}*U*t = A^{-1}*U*(C^{-1} + V*A^{-1}*U)^{-1}*V*A^{-1}*b
+        return y - Y_ * t;   // return system solution
+    }
+    // one-shot solution of (A + U*C*V)x = b. Prefer compute() followed by solve() if U, C and V do not change
     DMatrix<double> solve(
       const SparseSolver& invA, const DMatrix<double>& U, const DMatrix<double>& invC, const DMatrix<double>& V,
       const DMatrix<double>& b) {
-        DMatrix<double> y = invA.solve(b);   // y = A^{-1}b
-        // Y = A^{-1}U. Heavy step of the method. SMW is more and more efficient as q gets smaller and smaller
-        DMatrix<double> Y = invA.solve(U);
-        // compute dense matrix G = C^{-1} + V*A^{-1}*U = C^{-1} + V*y
-        DMatrix<double> G = invC + V * Y;
-        DenseSolver invG;
-        invG.compute(G);   // factorize qxq dense matrix G
-        DMatrix<double> t = invG.solve(V * y);
-        // v = A^{-1}*U*t = A^{-1}*U*(C^{-1} + V*A^{-1}*U)^{-1}*V*A^{-1}*b by solving linear system A*v = U*t
-        DMatrix<double> v = invA.solve(U * t);
-        return y - v;   // return system solution
+        return compute(invA, U, invC, V).solve(b);
     }
 };
 
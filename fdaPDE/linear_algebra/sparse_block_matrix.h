@@ -21,6 +21,7 @@
 #include <Eigen/Sparse>
 
 #include "../utils/assert.h"
+#include "../utils/symbols.h"
 
 namespace fdapde {
 namespace core {
@@ -92,31 +93,34 @@ struct SparseBlockMatrix :
     // non-const access to the (i,j)-th element
     Scalar& coeffRef(int row, int col) {
         fdapde_assert(row >= 0 && row < rows_ && col >= 0 && col < cols_);
-        return blocks_[innerBlockIndex(row) * Cols_ + outerBlockIndex(col)].coeffRef(
-          indexToBlockInner(row), indexToBlockOuter(col));
+        int i = innerBlockIndex(row), j = outerBlockIndex(col);
+        return blocks_[i * Cols_ + j].coeffRef(row - inner_offset_[i], col - outer_offset_[j]);
     }
     // const access to of the (i,j)-th element
     Scalar coeff(int row, int col) const {
         fdapde_assert(row >= 0 && row < rows_ && col >= 0 && col < cols_);
-        return blocks_[innerBlockIndex(row) * Cols_ + outerBlockIndex(col)].coeffRef(
-          indexToBlockInner(row), indexToBlockOuter(col));
+        int i = innerBlockIndex(row), j = outerBlockIndex(col);
+        return blocks_[i * Cols_ + j].coeff(row - inner_offset_[i], col - outer_offset_[j]);
     }
-    // the outer block index where i belongs to
+    // the outer block index where i belongs to (linear scan, the number of blocks is small and known at compile time)
     inline int outerBlockIndex(int i) const {
-        return std::distance(outer_offset_.begin(), std::upper_bound(outer_offset_.begin(), outer_offset_.end(), i)) - 1;
+        int j = 0;
+        while (j < Cols_ - 1 && outer_offset_[j + 1] <= i) ++j;
+        return j;
     }
     // the inner block index where i belongs to
     inline int innerBlockIndex(int i) const {
-        return std::distance(inner_offset_.begin(), std::upper_bound(inner_offset_.begin(), inner_offset_.end(), i)) - 1;
+        int j = 0;
+        while (j < Rows_ - 1 && inner_offset_[j + 1] <= i) ++j;
+        return j;
     }
     // the outer index relative to the block where i belongs to
-    inline int indexToBlockOuter(int i) const {
-        return i - *(std::upper_bound(outer_offset_.begin(), outer_offset_.end(), i) - 1);
-    }
+    inline int indexToBlockOuter(int i) const { return i - outer_offset_[outerBlockIndex(i)]; }
     // the inner index relative to the block where i belongs to
-    inline int indexToBlockInner(int i) const {
-        return i - *(std::upper_bound(inner_offset_.begin(), inner_offset_.end(), i) - 1);
-    }
+    inline int indexToBlockInner(int i) const { return i - inner_offset_[innerBlockIndex(i)]; }
+    // starting outer (inner) index of the j-th block column (row)
+    inline int outerBlockOffset(int j) const { return outer_offset_[j]; }
+    inline int innerBlockOffset(int i) const { return inner_offset_[i]; }
     inline bool isCompressed() const { return true; }   // matrix in compressed format (blocks are in compressed format)
    protected:
     std::vector<Eigen::SparseMatrix<Scalar>> blocks_ {};
@@ -127,6 +131,24 @@ struct SparseBlockMatrix :
     int cols_ = 0, rows_ = 0;                      // matrix dimensions
 };
 
+// block-aware product of a SparseBlockMatrix with a dense matrix. Each block multiplies the slice of x matching its
+// columns and accumulates in the slice of the result matching its rows, by the sparse kernel of the block itself
+template <typename Scalar_, int Rows_, int Cols_, int Options_, typename StorageIndex_, typename XType>
+DMatrix<Scalar_> operator*(
+  const SparseBlockMatrix<Scalar_, Rows_, Cols_, Options_, StorageIndex_>& A, const Eigen::MatrixBase<XType>& x) {
+    fdapde_assert(A.cols() == x.rows());
+    DMatrix<Scalar_> y = DMatrix<Scalar_>::Zero(A.rows(), x.cols());
+    for (int i = 0; i < Rows_; ++i) {
+        for (int j = 0; j < Cols_; ++j) {
+            const auto& block = A.block(i, j);
+            if (block.nonZeros() == 0) continue;
+            y.middleRows(A.innerBlockOffset(i), block.rows()).noalias() +=
+              block * x.middleRows(A.outerBlockOffset(j), block.cols());
+        }
+    }
+    return y;
+}
+
 }   // namespace core
 }   // namespace fdapde
 
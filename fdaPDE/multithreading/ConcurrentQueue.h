@@ -1,82 +1,238 @@
+// This file is part of fdaPDE, a C++ library for physics-informed
+// spatial and functional data analysis.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
 #ifndef __CONCURRENT_QUEUE_H__
 #define __CONCURRENT_QUEUE_H__
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <iterator>
+#include <memory>
 #include <mutex>
-#include <queue>
+#include <new>
 #include <optional>
+#include <thread>
+#include <utility>
 
-namespace fdaPDE {
-namespace multithreading {
+namespace fdapde {
+namespace core {
 
-  // a C++17 thread-safe std::queue implementation. Acts as a wrapper to std::queue with imposed thread safety
-  template <typename T>
-  class ConcurrentQueue {
-  private:
-    typedef std::queue<T> Container;
-    Container queue_;
-    std::mutex mutex_;
-  public:
-    using value_type      = typename Container::value_type;
-    using reference       = typename Container::reference;
-    using const_reference = typename Container::const_reference;
-    using size_type       = typename Container::size_type;
-    using container_type  =          Container;    
+// a lock-free bounded multi-producer multi-consumer FIFO queue. Elements are stored in a ring buffer whose slots carry
+// a sequence number, telling whether the slot is ready to be written by the producer holding ticket pos (sequence ==
+// pos) or read by the consumer holding ticket pos (sequence == pos + 1). Producers and consumers claim tickets with a
+// single compare-and-swap and never block each other, except when the queue is full (resp. empty)
+template <typename T> class ConcurrentQueue {
+   private:
+    static constexpr std::size_t cache_line = 64;
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+    std::unique_ptr<Slot[]> buffer_;
+    std::size_t mask_;
+    alignas(cache_line) std::atomic<std::size_t> enqueue_pos_ = 0;
+    alignas(cache_line) std::atomic<std::size_t> dequeue_pos_ = 0;
+    // claims the next ticket for a producer, returns nullptr if the queue is full
+    Slot* claim_push_slot_(std::size_t& pos) {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+        while (true) {
+            Slot* slot = &buffer_[pos & mask_];
+            std::size_t seq = slot->sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) return slot;
+            } else if (diff < 0) {
+                return nullptr;   // slot still holds the value pushed one lap before
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+   public:
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = std::size_t;
 
-    // construct empty queue
-    ConcurrentQueue() = default;
+    // construct empty queue able to hold at least capacity elements (rounded up to a power of two)
+    explicit ConcurrentQueue(size_type capacity = 1024) {
+        size_type size = 2;
+        while (size < capacity) size <<= 1;
+        buffer_.reset(new Slot[size]);
+        mask_ = size - 1;
+        for (size_type i = 0; i < size; ++i) { buffer_[i].sequence.store(i, std::memory_order_relaxed); }
+    }
     // construct using a range of value_type objects
     template <typename Iterator>
-    ConcurrentQueue(Iterator first, Iterator last) : queue_(first, last) {};
-    
-    // current number of elements in the queue, can be queried by any thread
-    size_type size() const { return queue_.size(); }
-    bool empty() const { return queue_.empty(); }
-    
-    // inserts element at the end
-    void push(const value_type& value) { 
-      std::lock_guard<std::mutex> lock(mutex_);
-      queue_.push(value);
+    ConcurrentQueue(Iterator first, Iterator last, size_type capacity = 1024) :
+        ConcurrentQueue(std::max<size_type>(capacity, std::distance(first, last))) {
+        for (; first != last; ++first) { try_push(*first); }
     }
+    ConcurrentQueue(const ConcurrentQueue&) = delete;
+    ConcurrentQueue& operator=(const ConcurrentQueue&) = delete;
 
-    // constructs element in-place at the end
-    template <typename... Args>
-    void emplace(Args&&... args){
-      std::lock_guard<std::mutex> lock(mutex_);
-      queue_.emplace(args...);
+    // current number of elements in the queue, exact only if no push or pop is in progress
+    size_type size() const {
+        size_type head = dequeue_pos_.load(std::memory_order_relaxed);
+        size_type tail = enqueue_pos_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+    bool empty() const { return size() == 0; }
+    size_type capacity() const { return mask_ + 1; }
+
+    // inserts element at the end, returns false if the queue is full
+    bool try_push(const value_type& value) { return try_emplace(value); }
+    bool try_push(value_type&& value) { return try_emplace(std::move(value)); }
+    // constructs element at the end, returns false if the queue is full
+    template <typename... Args> bool try_emplace(Args&&... args) {
+        std::size_t pos;
+        Slot* slot = claim_push_slot_(pos);
+        if (!slot) return false;
+        slot->value = T(std::forward<Args>(args)...);
+        slot->sequence.store(pos + 1, std::memory_order_release);   // publish value to consumers
+        return true;
+    }
+    // inserts element at the end, spins while the queue is full
+    void push(const value_type& value) { emplace(value); }
+    void push(value_type&& value) { emplace(std::move(value)); }
+    template <typename... Args> void emplace(Args&&... args) {
+        while (!try_emplace(args...)) std::this_thread::yield();
+    }
+
+    // removes and place into buff the first element, notifies with a boolean if extraction was ok
+    bool pop(value_type& buff) {
+        std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        while (true) {
+            Slot* slot = &buffer_[pos & mask_];
+            std::size_t seq = slot->sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    buff = std::move(slot->value);
+                    slot->sequence.store(pos + mask_ + 1, std::memory_order_release);   // free slot for next lap
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // nothing to extract
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
     }
-    
     // removes and returns the first element, returns an empty optional if queue is empty
     std::optional<value_type> pop() {
-      std::lock_guard<std::mutex> lock(mutex_);
-      if(queue_.empty()){
-	return std::nullopt; // return empty optional
-      }
-      // get first element and remove from queue
-      value_type value = queue_.front();
-      queue_.pop();
-      return std::optional<value_type>(value);
-    }
-    // removes and place into buffer the first element, notifies with a boolean if extraction was ok
+        value_type value;
+        if (!pop(value)) return std::nullopt;
+        return std::optional<value_type>(std::move(value));
+    }
+    // removes all elements from the queue
+    void clear() {
+        value_type value;
+        while (pop(value));
+    }
+};
+
+// blocking adapter for ConcurrentQueue. Fast paths are lock-free, a thread takes the mutex only when it has to sleep
+// because the queue is full (push) or empty (pop), or to wake up a sleeping thread
+template <typename T> class BlockingQueue {
+   private:
+    ConcurrentQueue<T> queue_;
+    std::mutex mutex_;
+    std::condition_variable not_empty_, not_full_;
+    std::atomic<int> waiting_pop_ = 0, waiting_push_ = 0;
+    std::atomic<bool> closed_ = false;
+
+    void notify_(std::atomic<int>& waiting, std::condition_variable& cv) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);   // order queue update before the load of waiting
+        if (waiting.load() > 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cv.notify_one();
+        }
+    }
+   public:
+    using value_type = T;
+    using size_type = std::size_t;
+    explicit BlockingQueue(size_type capacity = 1024) : queue_(capacity) { }
+
+    size_type size() const { return queue_.size(); }
+    bool empty() const { return queue_.empty(); }
+    size_type capacity() const { return queue_.capacity(); }
+    // inserts element at the end, waits while the queue is full. Returns false if the queue has been closed
+    template <typename... Args> bool emplace(Args&&... args) {
+        while (!queue_.try_emplace(args...)) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            waiting_push_.fetch_add(1);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            not_full_.wait(lock, [this]() { return queue_.size() < queue_.capacity() || closed_.load(); });
+            waiting_push_.fetch_sub(1);
+            if (closed_.load()) return false;
+        }
+        notify_(waiting_pop_, not_empty_);
+        return true;
+    }
+    bool push(const value_type& value) { return emplace(value); }
+    bool push(value_type&& value) { return emplace(std::move(value)); }
+    // extracts the first element, waits while the queue is empty. Returns false if the queue is empty and closed
     bool pop(value_type& buff) {
-      std::lock_guard<std::mutex> lock(mutex_);
-      if(queue_.empty()){
-	return false; // nothing to extract
-      }
-      // get first element and remove from queue
-      buff = queue_.front();
-      queue_.pop();
-      return true;
-    }
-    
-    // atomically removes all elements from the queue
+        while (!queue_.pop(buff)) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            waiting_pop_.fetch_add(1);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            not_empty_.wait(lock, [this]() { return !queue_.empty() || closed_.load(); });
+            waiting_pop_.fetch_sub(1);
+            if (queue_.empty() && closed_.load()) return false;
+        }
+        notify_(waiting_push_, not_full_);
+        return true;
+    }
+    std::optional<value_type> pop() {
+        value_type value;
+        if (!pop(value)) return std::nullopt;
+        return std::optional<value_type>(std::move(value));
+    }
+    // non-blocking access
+    bool try_push(const value_type& value) {
+        if (!queue_.try_push(value)) return false;
+        notify_(waiting_pop_, not_empty_);
+        return true;
+    }
+    bool try_pop(value_type& buff) {
+        if (!queue_.pop(buff)) return false;
+        notify_(waiting_push_, not_full_);
+        return true;
+    }
+    // wakes up all waiting threads, subsequent pushes fail and pops fail once the queue is drained
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
     void clear() {
-      std::lock_guard<std::mutex> lock(mutex_);
-      while(!queue_.empty()){
-	queue_.pop();
-      }
+        queue_.clear();
+        notify_(waiting_push_, not_full_);
     }
-  };
+};
 
-}}
+}   // namespace core
+}   // namespace fdapde
 
-#endif // __CONCURRENT_QUEUE_H__
+#endif   // __CONCURRENT_QUEUE_H__
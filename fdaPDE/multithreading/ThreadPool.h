@@ -1,117 +1,268 @@
+// This file is part of fdaPDE, a C++ library for physics-informed
+// spatial and functional data analysis.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
 #ifndef __THREAD_POOL_H__
 #define __THREAD_POOL_H__
 
-#include <thread>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "ConcurrentQueue.h"
 
-namespace fdaPDE{
-namespace multithreading {
+namespace fdapde {
+namespace core {
 
-  // thread pool implementation for parallel execution of jobs
-  class ThreadPool {
-  private:
-    // possible states for a worker thread in the pool
-    enum State { IDLE, BUSY };
-    std::vector<State> state_;
-    
-    ConcurrentQueue<std::function<void()>> task_queue_; 
-    std::vector<std::thread> thread_pool_;
+// a work-stealing thread pool. Each worker owns a deque of tasks: it pops from the back of its own deque (LIFO, cache
+// friendly for nested work) and, once empty, takes work submitted from outside the pool from a lock-free injection
+// queue, or steals from the front of the other deques. Threads waiting for the
+// completion of a parallel loop do not block, but help executing pending tasks. Tasks are plain structs holding a
+// function pointer and an index range, hence parallel loops do not allocate per chunk
+class ThreadPool {
+   private:
+    struct Task {
+        void (*run)(void*, int, int, int);   // run(data, begin, end, chunk_id)
+        void* data;
+        int begin, end, id;
+    };
+    struct Worker {
+        std::deque<Task> tasks;
+        std::mutex mutex;
+    };
+    // shared state of a parallel loop, lives on the stack of the calling thread
+    template <typename F> struct Job {
+        F* f;
+        std::atomic<int> remaining;
+        std::atomic<bool> failed = false;
+        std::exception_ptr exception;
+        Job(F* f_, int n) : f(f_), remaining(n) { }
+        static void run(void* data, int begin, int end, int id) {
+            Job* job = static_cast<Job*>(data);
+            if (!job->failed.load(std::memory_order_relaxed)) {
+                try {
+                    (*job->f)(begin, end, id);
+                } catch (...) {
+                    if (!job->failed.exchange(true)) job->exception = std::current_exception();
+                }
+            }
+            job->remaining.fetch_sub(1, std::memory_order_release);
+        }
+    };
 
-    std::mutex mutex_;
-    std::condition_variable pending_;
-    
-    bool kill_ = false; // if asserted true, ThreadPool stops its execution
-    bool sync_ = false; // if asserted true, sync on the task_queue is requested
-    std::mutex sync_mutex_;
-    std::condition_variable sync_condition_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    ConcurrentQueue<Task> injector_;   // tasks pushed from threads not belonging to the pool
+    std::vector<std::thread> threads_;
+    std::atomic<int> n_queued_ = 0;       // tasks pushed but not yet popped
+    std::atomic<int> n_unfinished_ = 0;   // tasks pushed but not yet completed
+    std::atomic<int> n_sleeping_ = 0;
+    std::atomic<bool> stop_ = false;
+    std::atomic<unsigned> next_ = 0;   // round-robin counter for the choice of deques
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    // identity of the calling thread, if it is a worker of some pool
+    static inline thread_local const ThreadPool* current_pool_ = nullptr;
+    static inline thread_local int current_worker_ = -1;
 
-    // main thread loop, this gets executed by any spawned thread
-    void execute(std::size_t thread_id) {
-      while(true) {
-	std::function<void()> task; // task's function object to execute
-	{
-	  // wait on condition variable
-	  std::unique_lock<std::mutex> lock(mutex_);
-	  pending_.wait(lock, [this, &task] {
-	    // if there is some pending job or kill signal arrived, stop wait
-	    return kill_ || task_queue_.pop(task); 
-	  });
-	} // release lock
-	
-	if(kill_) return; // stop if meanwhile a kill signal has been issued
-	state_[thread_id] = State::BUSY;
-	task(); // execute task
-	state_[thread_id] = State::IDLE;
-	if(sync_){ // notifies caller if pending for synchronization
-	  std::lock_guard<std::mutex> lock(sync_mutex_);
-	  sync_condition_.notify_one();
-	}
-      }
+    int this_worker_() const { return current_pool_ == this ? current_worker_ : -1; }
+    // pushes task on the deque of the calling worker, or on the injection queue if the caller is not a worker
+    void push_(const Task& task) {
+        n_unfinished_.fetch_add(1);
+        int w = this_worker_();
+        if (w == -1 && !injector_.try_push(task)) {   // injection queue full, fallback to some worker's deque
+            w = next_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+        }
+        if (w != -1) {
+            std::lock_guard<std::mutex> lock(workers_[w]->mutex);
+            workers_[w]->tasks.push_back(task);
+        }
+        n_queued_.fetch_add(1);
+        if (n_sleeping_.load() > 0) {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            wake_.notify_one();
+        }
     }
-    
-  public:
-    // constructor
-    ThreadPool() : ThreadPool(std::thread::hardware_concurrency()) {};
-    ThreadPool(std::size_t n_thread) : state_(n_thread, State::IDLE) {
-      // starts pool of n_threads
-      thread_pool_.reserve(n_thread);
-      for(std::size_t i = 0; i < n_thread; ++i){
-	thread_pool_.emplace_back(std::bind(&ThreadPool::execute, this, i));
-      }
+    // pops a task from the back of the w-th deque (if w is the calling worker) or steals one from the front
+    bool pop_(int w, bool steal, Task& task) {
+        Worker& worker = *workers_[w];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.tasks.empty()) return false;
+        if (steal) {
+            task = worker.tasks.front();
+            worker.tasks.pop_front();
+        } else {
+            task = worker.tasks.back();
+            worker.tasks.pop_back();
+        }
+        n_queued_.fetch_sub(1);
+        return true;
+    }
+    bool find_task_(Task& task) {
+        if (n_queued_.load() == 0) return false;
+        int w = this_worker_(), n = workers_.size();
+        if (w != -1 && pop_(w, false, task)) return true;
+        if (injector_.pop(task)) {
+            n_queued_.fetch_sub(1);
+            return true;
+        }
+        int start = w != -1 ? w + 1 : next_.load(std::memory_order_relaxed);
+        for (int i = 0; i < n; ++i) {
+            int victim = (start + i) % n;
+            if (victim != w && pop_(victim, true, task)) return true;
+        }
+        return false;
+    }
+    void run_(const Task& task) {
+        task.run(task.data, task.begin, task.end, task.id);
+        n_unfinished_.fetch_sub(1, std::memory_order_release);
+    }
+    // main loop of the w-th worker
+    void execute_(int w) {
+        current_pool_ = this;
+        current_worker_ = w;
+        Task task;
+        while (true) {
+            if (find_task_(task)) {
+                run_(task);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            n_sleeping_.fetch_add(1);
+            wake_.wait(lock, [this]() { return n_queued_.load() > 0 || stop_.load(); });
+            n_sleeping_.fetch_sub(1);
+            if (stop_.load() && n_queued_.load() == 0) return;
+        }
+    }
+   public:
+    explicit ThreadPool(int n_workers = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1)) {
+        n_workers = std::max(1, n_workers);
+        workers_.reserve(n_workers);
+        for (int i = 0; i < n_workers; ++i) { workers_.push_back(std::make_unique<Worker>()); }
+        threads_.reserve(n_workers);
+        for (int i = 0; i < n_workers; ++i) { threads_.emplace_back(&ThreadPool::execute_, this, i); }
     }
-
-    // avoid copy/move-constructors and copy/move assignments
     ThreadPool(const ThreadPool&) = delete;
     ThreadPool(ThreadPool&&) = delete;
     ThreadPool& operator=(const ThreadPool&) = delete;
     ThreadPool& operator=(ThreadPool&&) = delete;
-    
-    // send work to the pool
-    template <typename F, typename... Args>
-    auto send_async(F&& f, Args&&... args) -> std::future<decltype(f(args...))> {      
-      // wrap the callable target for asynchronous execution
-      typedef std::packaged_task<decltype(f(args...))()> task_type;
-      std::shared_ptr<task_type> task = std::make_shared<task_type>([=](){ return f(args...); });
-      std::future<decltype(f(args...))> future = task->get_future(); // get future associated with promised result
-      
-      // erase specific type of requested job
-      std::function<void()> wrapped_task = [task]() -> void { (*task)(); };
+    ~ThreadPool() { shutdown(); }
 
-      // put task on queue (concurrent push/pop handled by the queue)
-      task_queue_.push(wrapped_task);
-      // notify one thread, if any waiting for job
-      std::lock_guard<std::mutex> lock(mutex_);
-      pending_.notify_one();
-      return future;
+    int n_workers() const { return workers_.size(); }
+    // executes one pending task, if any, on the calling thread. Returns false if no task was found
+    bool run_pending_task() {
+        Task task;
+        if (!find_task_(task)) return false;
+        run_(task);
+        return true;
+    }
+    // splits [begin, end) in n_chunks contiguous ranges and calls f(chunk_begin, chunk_end, k) on the k-th range. The
+    // calling thread takes part in the execution and returns once all chunks are processed. The first exception
+    // raised by f is rethrown to the caller, chunks not yet started are then skipped
+    template <typename F> void for_each_chunk(int begin, int end, int n_chunks, F&& f) {
+        int n = end - begin;
+        if (n <= 0) return;
+        n_chunks = std::max(1, std::min(n_chunks, n));
+        if (n_chunks == 1) {   // nothing to split
+            f(begin, end, 0);
+            return;
+        }
+        using F_ = std::remove_reference_t<F>;
+        Job<F_> job(&f, n_chunks);
+        auto chunk_begin = [=](int k) -> int { return begin + static_cast<long long>(n) * k / n_chunks; };
+        auto make_task = [&](int k) { return Task {&Job<F_>::run, &job, chunk_begin(k), chunk_begin(k + 1), k}; };
+        if (this_worker_() != -1) {   // push in reverse order, so that the owner pops the first chunks first
+            for (int k = n_chunks - 1; k >= 0; --k) push_(make_task(k));
+        } else {   // the injection queue is FIFO
+            for (int k = 0; k < n_chunks; ++k) push_(make_task(k));
+        }
+        while (job.remaining.load(std::memory_order_acquire) > 0) {
+            if (!run_pending_task()) std::this_thread::yield();
+        }
+        if (job.failed.load()) std::rethrow_exception(job.exception);
+    }
+    // calls f(chunk_begin, chunk_end) on chunks of [begin, end) of at least grain indexes
+    template <typename F> void parallel_for(int begin, int end, int grain, F&& f) {
+        for_each_chunk(begin, end, n_chunks(end - begin, grain), [&f](int b, int e, int) { f(b, e); });
+    }
+    // computes reduce(...reduce(reduce(init, f(c_0)), f(c_1))..., f(c_{n-1})), being c_0, ..., c_{n-1} the chunks of
+    // [begin, end) in their natural order and f(chunk_begin, chunk_end) the partial result on a chunk. Partial results
+    // are combined serially on the calling thread
+    template <typename T, typename F, typename R>
+    T parallel_reduce(int begin, int end, int grain, T init, F&& f, R&& reduce) {
+        int n_chunks_ = n_chunks(end - begin, grain);
+        std::vector<T> partials(n_chunks_, init);
+        for_each_chunk(begin, end, n_chunks_, [&](int b, int e, int k) { partials[k] = f(b, e); });
+        for (int k = 0; k < n_chunks_ && end > begin; ++k) { init = reduce(init, partials[k]); }
+        return init;
+    }
+    // number of chunks of at least grain indexes in which a range of n indexes is split. Some more chunks than threads
+    // are produced, to let idle threads steal work from slower ones
+    int n_chunks(int n, int grain) const {
+        return std::max(1, std::min(4 * (n_workers() + 1), n / std::max(1, grain)));
     }
 
-    // blocks caller until all job sent is done
+    // send work to the pool, returns a future to the result of f(args...)
+    template <typename F, typename... Args> auto send_async(F&& f, Args&&... args) {
+        using R = std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>;
+        auto task = new std::packaged_task<R()>(
+          [f = std::forward<F>(f), ... args = std::forward<Args>(args)]() mutable { return f(args...); });
+        std::future<R> future = task->get_future();
+        auto run = [](void* data, int, int, int) {
+            auto task = static_cast<std::packaged_task<R()>*>(data);
+            (*task)();
+            delete task;
+        };
+        push_(Task {run, task, 0, 0, 0});
+        return future;
+    }
+    // blocks caller until all jobs sent to the pool are done. The calling thread helps executing pending jobs
     void sync() {
-      std::unique_lock<std::mutex> lock(sync_mutex_);
-      sync_ = true; // caller put on wait
-      sync_condition_.wait(lock, [this] {
-	return task_queue_.empty() &&
-	  std::all_of(state_.begin(), state_.end(), [](State s) { return s == State::IDLE; });
-      });
+        while (n_unfinished_.load(std::memory_order_acquire) > 0) {
+            if (!run_pending_task()) std::this_thread::yield();
+        }
     }
-
-    // terminate the pool, if some thread is executing a job, it will terminate at the end of the execution
+    // terminates the pool once all the pending jobs are done
     void shutdown() {
-      {
-	std::lock_guard<std::mutex> lock(mutex_);
-	kill_ = true;
-      } // release lock
-      pending_.notify_all(); // wake-up all threads, they will exit because of kill_ == true
-      // wait for thread to finish
-      for(auto& th : thread_pool_){
-	th.join();
-      }
-      return;
+        if (threads_.empty()) return;
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread& t : threads_) t.join();
+        threads_.clear();
     }
-  };
-  
-}}
+};
+
+// the thread pool shared by all the parallel algorithms of the library, started on first use
+inline ThreadPool& thread_pool() {
+    static ThreadPool pool;
+    return pool;
+}
+
+}   // namespace core
+}   // namespace fdapde
 
-#endif // __THREAD_POOL_H__
+#endif   // __THREAD_POOL_H__
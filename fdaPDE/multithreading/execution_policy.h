@@ -0,0 +1,132 @@
+// This file is part of fdaPDE, a C++ library for physics-informed
+// spatial and functional data analysis.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef __EXECUTION_POLICY_H__
+#define __EXECUTION_POLICY_H__
+
+#include <algorithm>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "ThreadPool.h"
+
+namespace fdapde {
+namespace core {
+namespace execution {
+
+// policies driving the execution of library loops. Parallel policies run on pool, or on the library pool if null
+struct sequential_policy { };   // single chunk, processed by the calling thread
+struct threaded_policy {        // chunks of at least grain indexes, balanced among the pool threads by work stealing
+    int grain = 256;
+    ThreadPool* pool = nullptr;
+};
+struct chunked_policy {   // fixed number of contiguous chunks (one per hardware thread if n_chunks <= 0)
+    int n_chunks = 0;
+    ThreadPool* pool = nullptr;
+};
+// bit-reproducible reductions: [0, n) is split in ceil(n / block) chunks whatever the number of threads, partial
+// results of chunks are then combined along a fixed binary tree (see tree_reduce()). The outcome of a reduction hence
+// only depends on n and block. Overhead with respect to threaded_policy: ceil(n / block) partial results are stored
+// and reduced (instead of a few per thread), and chunks are not sized on the pool, so that small ranges (n < block)
+// run serially and ranges much larger than block produce many small tasks. With block in the hundreds, the cost of
+// the reduction itself is negligible with respect to the per-index work of mesh loops
+struct reproducible_policy {
+    int block = 256;
+    ThreadPool* pool = nullptr;
+};
+inline constexpr sequential_policy seq {};
+inline constexpr threaded_policy par {};
+inline constexpr reproducible_policy reproducible {};
+// type-erased policy, to select the policy at run-time
+using any_policy = std::variant<sequential_policy, threaded_policy, chunked_policy, reproducible_policy>;
+
+// the policy used by library loops whenever the caller does not supply one. Sequential unless set otherwise, this is
+// the single switch to turn on parallelism in mesh traversals, integration and assembly
+inline any_policy& default_policy() {
+    static any_policy policy = sequential_policy {};
+    return policy;
+}
+inline void set_default_policy(const any_policy& policy) { default_policy() = policy; }
+
+}   // namespace execution
+
+template <typename T> struct is_execution_policy {
+    static constexpr bool value = std::is_same_v<T, execution::sequential_policy> ||
+                                  std::is_same_v<T, execution::threaded_policy> ||
+                                  std::is_same_v<T, execution::chunked_policy> ||
+                                  std::is_same_v<T, execution::reproducible_policy> ||
+                                  std::is_same_v<T, execution::any_policy>;
+};
+// true if reductions under policy give the same result whatever the number of threads
+inline bool is_reproducible(const execution::sequential_policy&) { return true; }
+inline bool is_reproducible(const execution::threaded_policy&) { return false; }
+inline bool is_reproducible(const execution::chunked_policy&) { return false; }
+inline bool is_reproducible(const execution::reproducible_policy&) { return true; }
+inline bool is_reproducible(const execution::any_policy& policy) {
+    return std::visit([](const auto& p) { return is_reproducible(p); }, policy);
+}
+
+// number of chunks in which a range of n indexes is split when processed with the given policy
+inline int n_chunks(int, const execution::sequential_policy&) { return 1; }
+inline int n_chunks(int n, const execution::threaded_policy& policy) {
+    ThreadPool& pool = policy.pool ? *policy.pool : thread_pool();
+    return std::max(1, std::min(n, pool.n_chunks(n, policy.grain)));
+}
+inline int n_chunks(int n, const execution::chunked_policy& policy) {
+    int k = policy.n_chunks > 0 ? policy.n_chunks : static_cast<int>(std::thread::hardware_concurrency());
+    return std::max(1, std::min(n, k));
+}
+inline int n_chunks(int n, const execution::reproducible_policy& policy) {
+    int block = std::max(1, policy.block);
+    return std::max(1, (n + block - 1) / block);
+}
+inline int n_chunks(int n, const execution::any_policy& policy) {
+    return std::visit([n](const auto& p) { return n_chunks(n, p); }, policy);
+}
+
+// splits [0, n) in n_chunks(n, policy) contiguous ranges and calls f(begin, end, k) on the k-th range
+template <typename Policy, typename F> void for_each_chunk(int n, const Policy& policy, F&& f) {
+    if (n <= 0) return;
+    if constexpr (std::is_same_v<Policy, execution::any_policy>) {
+        std::visit([&](const auto& p) { for_each_chunk(n, p, f); }, policy);
+    } else if constexpr (std::is_same_v<Policy, execution::sequential_policy>) {
+        f(0, n, 0);
+    } else {
+        ThreadPool& pool = policy.pool ? *policy.pool : thread_pool();
+        pool.for_each_chunk(0, n, n_chunks(n, policy), f);
+    }
+}
+
+// reduces values by pairwise combination along a fixed binary tree: at step s = 1, 2, 4, ..., values[i] is replaced
+// by reduce(values[i], values[i + s]) for i multiple of 2s. The order of operations only depends on values.size().
+// Returns init if values is empty, values is overwritten
+template <typename T, typename Reduce> T tree_reduce(std::vector<T>& values, T init, Reduce&& reduce) {
+    std::size_t n = values.size();
+    if (n == 0) return init;
+    for (std::size_t step = 1; step < n; step *= 2) {
+        for (std::size_t i = 0; i + step < n; i += 2 * step) { values[i] = reduce(values[i], values[i + step]); }
+    }
+    return reduce(init, values[0]);
+}
+
+}   // namespace core
+}   // namespace fdapde
+
+#endif   // __EXECUTION_POLICY_H__
@@ -0,0 +1,54 @@
+// This file is part of fdaPDE, a C++ library for physics-informed
+// spatial and functional data analysis.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __PARALLEL_FOR_H__
+#define __PARALLEL_FOR_H__
+
+#include <algorithm>
+#include <thread>
+
+#include "ThreadPool.h"
+
+namespace fdapde {
+namespace core {
+
+// number of chunks in which a range of n indexes is split for parallel processing, such that each chunk has at least
+// grain indexes and there are no more chunks than threads
+inline int n_parallel_chunks(int n, int grain, int n_threads = std::thread::hardware_concurrency()) {
+    return std::max(1, std::min(n_threads, n / std::max(1, grain)));
+}
+
+// splits [0, n) in n_chunks contiguous ranges and calls f(begin, end, k) on the k-th range concurrently, using the
+// library thread pool. The calling thread takes part in the computation, exceptions raised by f are propagated to the
+// caller
+template <typename F> void parallel_for_chunks(int n, int n_chunks, F&& f) {
+    thread_pool().for_each_chunk(0, n, n_chunks, std::forward<F>(f));
+}
+// calls f(begin, end) on chunks of [begin, end) having at least grain indexes, using the library thread pool
+template <typename F> void parallel_for(int begin, int end, int grain, F&& f) {
+    thread_pool().parallel_for(begin, end, grain, std::forward<F>(f));
+}
+// reduces the partial results f(chunk_begin, chunk_end) computed on chunks of [begin, end) with the binary operation
+// reduce, starting from init. Partial results are combined in chunk order
+template <typename T, typename F, typename R>
+T parallel_reduce(int begin, int end, int grain, T init, F&& f, R&& reduce) {
+    return thread_pool().parallel_reduce(begin, end, grain, init, std::forward<F>(f), std::forward<R>(reduce));
+}
+
+}   // namespace core
+}   // namespace fdapde
+
+#endif   // __PARALLEL_FOR_H__
@@ -20,8 +20,11 @@
 #include "optimization/optimizer.h"
 #include "optimization/grid.h"
 #include "optimization/newton.h"
+#include "optimization/newton_cg.h"
 #include "optimization/gradient_descent.h"
 #include "optimization/bfgs.h"
+#include "optimization/lbfgs.h"
+#include "optimization/cached_objective.h"
 #include "optimization/callbacks/callbacks.h"
 #include "optimization/callbacks/backtracking_line_search.h"
 #include "optimization/callbacks/wolfe_line_search.h"
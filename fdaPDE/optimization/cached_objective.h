@@ -0,0 +1,119 @@
+// This file is part of fdaPDE, a C++ library for physics-informed
+// spatial and functional data analysis.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef __CACHED_OBJECTIVE_H__
+#define __CACHED_OBJECTIVE_H__
+
+#include <vector>
+
+#include "../utils/assert.h"
+#include "../utils/symbols.h"
+#include "callbacks/callbacks.h"
+
+namespace fdapde {
+namespace core {
+
+// a memoization layer for an objective F, to be passed to optimizers in place of F. Remembers the last capacity
+// triples (x, f(x), \nabla f(x)), so that points visited both by a line search and by the optimizer loop (trial points,
+// the accepted point, the final optimum) are evaluated only once. The gradient functor of F is built once, derive()
+// returns a lightweight view on the cache. Points are matched by exact equality, F must be a pure function of x
+template <typename F> class CachedObjective {
+   public:
+    static constexpr int DomainDimension = F::DomainDimension;
+    using VectorType =
+      typename std::conditional<DomainDimension == Dynamic, DVector<double>, SVector<DomainDimension>>::type;
+   private:
+    using GradientType = decltype(std::declval<F&>().derive());
+    struct Entry {
+        VectorType x, grad;
+        double value;
+        bool has_value = false, has_grad = false;
+    };
+    F* f_;
+    GradientType grad_;
+    std::vector<Entry> cache_;
+    int next_ = 0;   // next entry to overwrite (round-robin)
+    int n_evals_ = 0, n_grad_evals_ = 0, n_hits_ = 0;
+
+    // returns the entry for x, inserting it (with no value nor gradient) if not found
+    Entry& lookup_(const VectorType& x) {
+        for (Entry& e : cache_) {
+            if ((e.has_value || e.has_grad) && e.x.rows() == x.rows() && e.x == x) { return e; }
+        }
+        Entry& e = cache_[next_];
+        next_ = (next_ + 1) % cache_.size();
+        e.x = x;
+        e.has_value = false, e.has_grad = false;
+        return e;
+    }
+   public:
+    // a gradient functor reading from the cache of its parent objective
+    class CachedGradient {
+        CachedObjective* obj_;
+       public:
+        CachedGradient(CachedObjective* obj) : obj_(obj) { }
+        VectorType operator()(const VectorType& x) const { return obj_->gradient(x); }
+    };
+    // constructor
+    CachedObjective(F& f, int capacity = 4) : f_(&f), grad_(f.derive()), cache_(capacity) {
+        fdapde_assert(capacity > 0);
+    }
+    CachedObjective(const CachedObjective&) = delete;   // the gradient view refers to this object
+    CachedObjective& operator=(const CachedObjective&) = delete;
+
+    double operator()(const VectorType& x) {
+        Entry& e = lookup_(x);
+        if (e.has_value) {
+            n_hits_++;
+        } else {
+            e.value = (*f_)(x);
+            e.has_value = true;
+            n_evals_++;
+        }
+        return e.value;
+    }
+    VectorType gradient(const VectorType& x) {
+        Entry& e = lookup_(x);
+        if (e.has_grad) {
+            n_hits_++;
+        } else {
+            e.grad = grad_(x);
+            e.has_grad = true;
+            n_grad_evals_++;
+        }
+        return e.grad;
+    }
+    CachedGradient derive() { return CachedGradient(this); }
+    decltype(auto) derive_twice() { return f_->derive_twice(); }   // hessian evaluations are not cached
+    // forward the stopping criterion of F, if any
+    template <typename Opt>
+    bool opt_stopping_criterion(Opt& opt) requires(has_opt_stopping_criterion<F, bool(Opt&)>::value) {
+        return f_->opt_stopping_criterion(opt);
+    }
+    void clear() {
+        for (Entry& e : cache_) { e.has_value = false, e.has_grad = false; }
+    }
+    // getters
+    int n_evaluations() const { return n_evals_; }                 // number of evaluations of F
+    int n_gradient_evaluations() const { return n_grad_evals_; }   // number of evaluations of \nabla F
+    int n_hits() const { return n_hits_; }                         // number of requests served by the cache
+};
+
+}   // namespace core
+}   // namespace fdapde
+
+#endif   // __CACHED_OBJECTIVE_H__
@@ -37,9 +37,9 @@ class BacktrackingLineSearch {
     template <typename Opt, typename Obj> bool pre_update_step(Opt& opt, Obj& obj) {
         double alpha = alpha_;   // restore to user defined settings
         double m = opt.grad_old.dot(opt.update);
-        if (m < 0) {                                                      // descent direction
-            while (obj(opt.x_old) - obj(opt.x_old + alpha * opt.update)   // Armijo–Goldstein condition
-		   + gamma_ * alpha * m < 0) {
+        if (m < 0) {                         // descent direction
+            double f_old = obj(opt.x_old);   // constant along the search, evaluate once
+            while (f_old - obj(opt.x_old + alpha * opt.update) + gamma_ * alpha * m < 0) {   // Armijo–Goldstein
                 alpha *= beta_;
             }
         }
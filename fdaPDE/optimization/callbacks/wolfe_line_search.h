@@ -44,12 +44,14 @@ class WolfeLineSearch {
 	// initialization
         bool stop = false;
         double m = opt.grad_old.dot(opt.update);
+        double f_old = obj(opt.x_old);   // constant along the search, evaluate once
+        auto grad = obj.derive();
         while (!stop) {
-            if (obj(opt.x_old) - obj(opt.x_old + alpha * opt.update)   // Armijo–Goldstein condition
-                + c1 * alpha * m < 0) {
+            typename std::decay<decltype(opt.x_old)>::type x = opt.x_old + alpha * opt.update;   // trial point
+            if (f_old - obj(x) + c1 * alpha * m < 0) {   // Armijo–Goldstein condition
                 alpha_max = alpha;
                 alpha = (alpha_min + alpha_max) * 0.5;
-            } else if (obj.derive()(opt.x_old + alpha * opt.update).dot(opt.update) < c2 * m) {   // curvature condition
+            } else if (grad(x).dot(opt.update) < c2 * m) {   // curvature condition
                 alpha_min = alpha;
                 alpha = (std::isinf(alpha_max)) ? 2 * alpha_min : (alpha_min + alpha_max) * 0.5;
             } else {
@@ -17,30 +17,42 @@
 #ifndef __GRID_H__
 #define __GRID_H__
 
+#include <chrono>
+#include <limits>
+
 #include "../fields.h"
+#include "../multithreading/execution_policy.h"
 #include "../utils/symbols.h"
 #include "callbacks/callbacks.h"
 
 namespace fdapde {
 namespace core {
 
-// searches for the point in a given grid minimizing a given nonlinear objective
+// searches for the point in a given grid minimizing a given nonlinear objective. Under a parallel execution policy,
+// grid rows are evaluated concurrently, each chunk of rows by its own copy of the objective (which must hence be copy
+// constructible, and copies must not share mutable state). Rows are then scanned in order: callbacks are replayed on
+// each row after the first one and the argmin is selected exactly as in the sequential case. Since all rows are
+// evaluated before the scan, an early stop discards (rather than saves) the evaluations past the stopping row
 template <int N, typename... Args> class Grid {
    private:
     using VectorType = typename std::conditional_t<N == Dynamic, DVector<double>, SVector<N>>;
     using GridType = Eigen::Matrix<double, Eigen::Dynamic, N>;   // equivalent to DMatrix<double> for N == Dynamic
     std::tuple<Args...> callbacks_ {};
+    execution::any_policy policy_ = execution::sequential_policy {};
     VectorType optimum_;
-    double value_;   // objective value at optimum
+    double value_;                   // objective value at optimum
+    DVector<double> evaluations_;    // objective value at each grid row (NaN if not evaluated)
+    DVector<double> timings_;        // wall-clock time (in seconds) spent in each evaluation (NaN if not evaluated)
    public:
     VectorType x_current;
     // constructor
     Grid() requires(sizeof...(Args) != 0) { }
     Grid(Args&&... callbacks) : callbacks_(std::make_tuple(std::forward<Args>(callbacks)...)) { }
     // copy semantic
-    Grid(const Grid& other) : callbacks_(other.callbacks_) { }
+    Grid(const Grid& other) : callbacks_(other.callbacks_), policy_(other.policy_) { }
     Grid& operator=(const Grid& other) {
         callbacks_ = other.callbacks_;
+        policy_ = other.policy_;
         return *this;
     }
     template <typename F> VectorType optimize(F& objective, const GridType& grid) {
@@ -48,14 +60,34 @@ template <int N, typename... Args> class Grid {
           std::is_same<decltype(std::declval<F>().operator()(VectorType())), double>::value,
           "F_IS_NOT_A_FUNCTOR_ACCEPTING_A_VECTORTYPE");
         bool stop = false;   // asserted true in case of forced stop
+        int n_rows = grid.rows();
+        evaluations_ = DVector<double>::Constant(n_rows, std::numeric_limits<double>::quiet_NaN());
+        timings_ = DVector<double>::Constant(n_rows, std::numeric_limits<double>::quiet_NaN());
+        auto evaluate = [&](F& obj, int i) {
+            auto start = std::chrono::steady_clock::now();
+            evaluations_[i] = obj(VectorType(grid.row(i)));
+            timings_[i] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        };
+        bool parallel = false;
+        if constexpr (std::is_copy_constructible_v<F>) {
+            if (n_chunks(n_rows, policy_) > 1) {
+                for_each_chunk(n_rows, policy_, [&](int begin, int end, [[maybe_unused]] int k) {
+                    F obj(objective);   // thread-local copy of the objective
+                    for (int i = begin; i < end; ++i) { evaluate(obj, i); }
+                });
+                parallel = true;
+            }
+        }
         // algorithm initialization
         x_current = grid.row(0);
-        value_ = objective(x_current);
+        if (!parallel) evaluate(objective, 0);
+        value_ = evaluations_[0];
         optimum_ = x_current;
         // optimize field over supplied grid
-        for (int i = 1; i < grid.rows() && !stop; ++i) {
+        for (int i = 1; i < n_rows && !stop; ++i) {
             x_current = grid.row(i);
-            double x = objective(x_current);
+            if (!parallel) evaluate(objective, i);
+            double x = evaluations_[i];
             stop |= execute_post_update_step(*this, objective, callbacks_);
             // update minimum if better optimum found
             if (x < value_) {
@@ -65,9 +97,13 @@ template <int N, typename... Args> class Grid {
         }
         return optimum_;
     }
+    // evaluate grid rows according to policy (sequential by default)
+    void set_execution_policy(const execution::any_policy& policy) { policy_ = policy; }
     // getters
     VectorType optimum() const { return optimum_; }
     double value() const { return value_; }
+    const DVector<double>& evaluations() const { return evaluations_; }
+    const DVector<double>& timings() const { return timings_; }
 };
 
 }   // namespace core
@@ -0,0 +1,151 @@
+// This file is part of fdaPDE, a C++ library for physics-informed
+// spatial and functional data analysis.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef __LBFGS_H__
+#define __LBFGS_H__
+
+#include "../fields.h"
+#include "../utils/symbols.h"
+#include "callbacks/callbacks.h"
+
+namespace fdapde {
+namespace core {
+
+// implementation of the limited-memory BFGS algorithm for unconstrained nonlinear optimization. The inverse hessian is
+// never formed: only the last mem_size pairs (s_k, y_k) = (x_{k+1} - x_k, \nabla f(x_{k+1}) - \nabla f(x_k)) are kept
+// and the update direction is computed by the two-loop recursion, requiring O(mem_size * N) memory and flops.
+// check "Jorge Nocedal, Stephen J. Wright (2006), Numerical Optimization", Algorithm 7.4
+template <int N, typename... Args> class LBFGS {
+   private:
+    using VectorType = typename std::conditional<N == Dynamic, DVector<double>, SVector<N>>::type;
+    using MemoryType = Eigen::Matrix<double, N, Eigen::Dynamic>;   // pairs (s_k, y_k) stored column-wise
+    int max_iter_;          // maximum number of iterations before forced stop
+    int n_iter_ = 0;        // current iteration number
+    double tol_;            // tolerance on error before forced stop
+    double step_;           // update step
+    int mem_size_ = 10;     // number of stored correction pairs
+    std::tuple<Args...> callbacks_;
+
+    VectorType optimum_;
+    double value_;   // objective value at optimum
+    // circular buffer of correction pairs, the most recent one is stored at column head_
+    MemoryType s_, y_;
+    DVector<double> rho_, alpha_;   // rho_k = 1 / (y_k^\top s_k), two-loop recursion coefficients
+    int head_ = -1, n_pairs_ = 0;
+
+    // two-loop recursion, computes update = -H_k * grad_old
+    void compute_update_() {
+        update = -grad_old;
+        for (int i = 0, k = head_; i < n_pairs_; ++i, k = (k + mem_size_ - 1) % mem_size_) {
+            alpha_[k] = rho_[k] * s_.col(k).dot(update);
+            update -= alpha_[k] * y_.col(k);
+        }
+        // initial inverse hessian approximation H_k^0 = (s_k^\top y_k) / (y_k^\top y_k) * I
+        if (n_pairs_ > 0) update *= 1.0 / (rho_[head_] * y_.col(head_).squaredNorm());
+        int oldest = (head_ + mem_size_ - n_pairs_ + 1) % mem_size_;
+        for (int i = 0, k = oldest; i < n_pairs_; ++i, k = (k + 1) % mem_size_) {
+            double beta = rho_[k] * y_.col(k).dot(update);
+            update += (alpha_[k] - beta) * s_.col(k);
+        }
+    }
+   public:
+    VectorType x_old, x_new, update, grad_old, grad_new;
+    double h;
+
+    // constructor
+    LBFGS() = default;
+    template <int N_ = sizeof...(Args), typename std::enable_if<N_ != 0, int>::type = 0>
+    LBFGS(int max_iter, double tol, double step) : max_iter_(max_iter), tol_(tol), step_(step) { }
+    template <int N_ = sizeof...(Args), typename std::enable_if<N_ != 0, int>::type = 0>
+    LBFGS(int max_iter, double tol, double step, int mem_size) :
+        max_iter_(max_iter), tol_(tol), step_(step), mem_size_(mem_size) { }
+    LBFGS(int max_iter, double tol, double step, Args&&... callbacks) :
+        max_iter_(max_iter), tol_(tol), step_(step), callbacks_(std::make_tuple(std::forward<Args>(callbacks)...)) { }
+    LBFGS(int max_iter, double tol, double step, int mem_size, Args&&... callbacks) :
+        max_iter_(max_iter), tol_(tol), step_(step), mem_size_(mem_size),
+        callbacks_(std::make_tuple(std::forward<Args>(callbacks)...)) { }
+    // copy semantic
+    LBFGS(const LBFGS& other) :
+        max_iter_(other.max_iter_), tol_(other.tol_), step_(other.step_), mem_size_(other.mem_size_),
+        callbacks_(other.callbacks_) { }
+    LBFGS& operator=(const LBFGS& other) {
+        max_iter_ = other.max_iter_;
+        tol_ = other.tol_;
+        step_ = other.step_;
+        mem_size_ = other.mem_size_;
+        callbacks_ = other.callbacks_;
+        return *this;
+    }
+
+    template <typename F> VectorType optimize(F& obj, const VectorType& x0) {
+        static_assert(
+          std::is_same<decltype(std::declval<F>().operator()(VectorType())), double>::value,
+          "F_IS_NOT_A_FUNCTOR_ACCEPTING_A_VECTORTYPE");
+        fdapde_assert(mem_size_ > 0);
+        bool stop = false;   // asserted true in case of forced stop
+        double error = 0;
+        auto grad = obj.derive();
+        n_iter_ = 0;
+        h = step_;
+        x_old = x0, x_new = x0;
+        s_.resize(x0.rows(), mem_size_);
+        y_.resize(x0.rows(), mem_size_);
+        rho_.resize(mem_size_);
+        alpha_.resize(mem_size_);
+        head_ = -1, n_pairs_ = 0;
+        grad_old = grad(x_old);
+        error = grad_old.norm();
+
+        while (n_iter_ < max_iter_ && error > tol_ && !stop) {
+            // compute update direction
+            compute_update_();
+            stop |= execute_pre_update_step(*this, obj, callbacks_);
+            // update along descent direction
+            x_new = x_old + h * update;
+            grad_new = grad(x_new);
+            // store correction pair, provided the curvature condition s_k^\top y_k > 0 holds (otherwise the implicit
+            // inverse hessian approximation would lose positive definiteness)
+            double sy = (x_new - x_old).dot(grad_new - grad_old);
+            if (sy > std::numeric_limits<double>::epsilon() * (grad_new - grad_old).squaredNorm()) {
+                head_ = (head_ + 1) % mem_size_;
+                s_.col(head_) = x_new - x_old;
+                y_.col(head_) = grad_new - grad_old;
+                rho_[head_] = 1.0 / sy;
+                n_pairs_ = std::min(n_pairs_ + 1, mem_size_);
+            }
+            // prepare next iteration
+            error = grad_new.norm();
+            stop |= (execute_post_update_step(*this, obj, callbacks_) || execute_obj_stopping_criterion(*this, obj));
+            x_old = x_new;
+            grad_old = grad_new;
+            n_iter_++;
+        }
+        optimum_ = x_old;
+        value_ = obj(optimum_);
+        return optimum_;
+    }
+
+    // getters
+    VectorType optimum() const { return optimum_; }
+    double value() const { return value_; }
+    int n_iter() const { return n_iter_; }
+};
+
+}   // namespace core
+}   // namespace fdapde
+
+#endif   // __LBFGS_H__
@@ -0,0 +1,151 @@
+// This file is part of fdaPDE, a C++ library for physics-informed
+// spatial and functional data analysis.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef __NEWTON_CG_H__
+#define __NEWTON_CG_H__
+
+#include "../fields.h"
+#include "../utils/symbols.h"
+#include "callbacks/callbacks.h"
+
+namespace fdapde {
+namespace core {
+
+// implementation of the truncated (hessian-free) newton method for unconstrained nonlinear optimization. The newton
+// system \nabla^2 f(x_k) * d = -\nabla f(x_k) is solved inexactly by conjugate gradient iterations, which only require
+// hessian-vector products: these are obtained from F::hessp(x, v), if F exposes it, or by forward finite differences
+// of the gradient along v otherwise. The hessian is never formed, memory is O(N) and each iteration costs at most
+// max_cg_iter hessian-vector products. Check "Jorge Nocedal, Stephen J. Wright (2006), Numerical Optimization",
+// Algorithm 7.1
+template <int N, typename... Args> class NewtonCG {
+   private:
+    using VectorType = typename std::conditional<N == Dynamic, DVector<double>, SVector<N>>::type;
+    int max_iter_;            // maximum number of iterations before forced stop
+    double tol_;              // tolerance on error before forced stop
+    double step_;             // update step
+    int max_cg_iter_ = -1;    // maximum number of inner CG iterations (-1: problem dimension)
+    int n_iter_ = 0;          // current iteration number
+    int n_cg_iter_ = 0;       // overall number of inner CG iterations
+    std::tuple<Args...> callbacks_;
+
+    VectorType optimum_;
+    double value_;   // objective value at optimum
+
+    // approximates the newton direction, update = -(\nabla^2 f(x_old))^{-1} * grad_old, by truncated CG
+    template <typename F, typename G> void compute_update_(F& obj, G& grad, int max_cg_iter) {
+        // hessian-vector product \nabla^2 f(x_old) * v
+        auto hessp = [&](const VectorType& v) -> VectorType {
+            if constexpr (requires(F f, VectorType x) { { f.hessp(x, x) }; }) {
+                return obj.hessp(x_old, v);
+            } else {
+                double eps = std::sqrt(std::numeric_limits<double>::epsilon()) * (1 + x_old.norm()) / v.norm();
+                return (grad(VectorType(x_old + eps * v)) - grad_old) / eps;
+            }
+        };
+        double g_norm = grad_old.norm();
+        double eta = std::min(0.5, std::sqrt(g_norm)) * g_norm;   // forcing term, superlinear convergence
+        update = VectorType::Zero(x_old.rows());
+        VectorType r = grad_old, d = -grad_old, Bd;   // residual of \nabla^2 f(x_old) * update + grad_old = 0
+        double rr = r.squaredNorm();
+        for (int j = 0; j < max_cg_iter; ++j, ++n_cg_iter_) {
+            Bd = hessp(d);
+            double dBd = d.dot(Bd);
+            if (dBd <= 0) {   // negative curvature, stop at last iterate (steepest descent if none)
+                if (j == 0) update = d;
+                break;
+            }
+            double alpha = rr / dBd;
+            update += alpha * d;
+            r += alpha * Bd;
+            double rr_new = r.squaredNorm();
+            if (std::sqrt(rr_new) < eta) break;
+            d = -r + (rr_new / rr) * d;
+            rr = rr_new;
+        }
+    }
+   public:
+    VectorType x_old, x_new, update, grad_old, grad_new;
+    double h;
+
+    // constructor
+    NewtonCG() = default;
+    template <int N_ = sizeof...(Args), typename std::enable_if<N_ != 0, int>::type = 0>
+    NewtonCG(int max_iter, double tol, double step) : max_iter_(max_iter), tol_(tol), step_(step) { }
+    template <int N_ = sizeof...(Args), typename std::enable_if<N_ != 0, int>::type = 0>
+    NewtonCG(int max_iter, double tol, double step, int max_cg_iter) :
+        max_iter_(max_iter), tol_(tol), step_(step), max_cg_iter_(max_cg_iter) { }
+    NewtonCG(int max_iter, double tol, double step, Args&&... callbacks) :
+        max_iter_(max_iter), tol_(tol), step_(step), callbacks_(std::make_tuple(std::forward<Args>(callbacks)...)) { }
+    NewtonCG(int max_iter, double tol, double step, int max_cg_iter, Args&&... callbacks) :
+        max_iter_(max_iter), tol_(tol), step_(step), max_cg_iter_(max_cg_iter),
+        callbacks_(std::make_tuple(std::forward<Args>(callbacks)...)) { }
+    // copy semantic
+    NewtonCG(const NewtonCG& other) :
+        max_iter_(other.max_iter_), tol_(other.tol_), step_(other.step_), max_cg_iter_(other.max_cg_iter_),
+        callbacks_(other.callbacks_) { }
+    NewtonCG& operator=(const NewtonCG& other) {
+        max_iter_ = other.max_iter_;
+        tol_ = other.tol_;
+        step_ = other.step_;
+        max_cg_iter_ = other.max_cg_iter_;
+        callbacks_ = other.callbacks_;
+        return *this;
+    }
+
+    template <typename F> VectorType optimize(F& obj, const VectorType& x0) {
+        static_assert(
+          std::is_same<decltype(std::declval<F>().operator()(VectorType())), double>::value,
+          "F_IS_NOT_A_FUNCTOR_ACCEPTING_A_VECTORTYPE");
+        bool stop = false;   // asserted true in case of forced stop
+        double error = 0;
+        auto grad = obj.derive();
+        int max_cg_iter = max_cg_iter_ > 0 ? max_cg_iter_ : x0.rows();
+        n_iter_ = 0, n_cg_iter_ = 0;
+        h = step_;
+        x_old = x0, x_new = x0;
+        grad_old = grad(x_old);
+        error = grad_old.norm();
+
+        while (n_iter_ < max_iter_ && error > tol_ && !stop) {
+            // compute update direction
+            compute_update_(obj, grad, max_cg_iter);
+            stop |= execute_pre_update_step(*this, obj, callbacks_);
+            // update along descent direction
+            x_new = x_old + h * update;
+            grad_new = grad(x_new);
+            // prepare next iteration
+            error = grad_new.norm();
+            stop |= (execute_post_update_step(*this, obj, callbacks_) || execute_obj_stopping_criterion(*this, obj));
+            x_old = x_new;
+            grad_old = grad_new;
+            n_iter_++;
+        }
+        optimum_ = x_old;
+        value_ = obj(optimum_);
+        return optimum_;
+    }
+    // getters
+    VectorType optimum() const { return optimum_; }
+    double value() const { return value_; }
+    int n_iter() const { return n_iter_; }
+    int n_cg_iter() const { return n_cg_iter_; }
+};
+
+}   // namespace core
+}   // namespace fdapde
+
+#endif   // __NEWTON_CG_H__
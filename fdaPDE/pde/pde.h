@@ -75,6 +75,7 @@ class PDE {
     void set_differential_operator(OperatorType diff_op) { diff_op_ = diff_op; }
     void set_dirichlet_bc(const DMatrix<double>& data) { boundary_data_ = data; }
     void set_initial_condition(const DVector<double>& data) { initial_condition_ = data; };
+    void set_mass_lumping(bool lump_mass) { solver_.set_mass_lumping(lump_mass); }   // to be called before init()
     // getters
     const SpaceDomainType& domain() const { return domain_; }
     const DVector<double>& time_domain() const { return time_domain_; }
@@ -86,8 +87,8 @@ class PDE {
     const FunctionalBasis& basis() const { return solver_.basis(); }
     const ReferenceBasis& reference_basis() const { return solver_.reference_basis(); }
     // evaluates the functional basis defined over the pyhisical domain on a given set of locations
-    template <template <typename> typename EvaluationPolicy>
-    std::pair<SpMatrix<double>, DVector<double>> eval_functional_basis(const DMatrix<double>& locs) const {
+    template <template <typename> typename EvaluationPolicy, typename LocsType>
+    std::pair<SpMatrix<double>, DVector<double>> eval_functional_basis(const LocsType& locs) const {
         return solver_.basis().template eval<EvaluationPolicy>(locs);
     }
     int n_dofs() const { return solver_.n_dofs(); }
@@ -17,6 +17,9 @@
 #ifndef __SPLINE_H__
 #define __SPLINE_H__
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <limits>
 #include "../../fields/scalar_field.h"
 #include "../../fields/scalar_expressions.h"
@@ -29,57 +32,121 @@ namespace core {
 //
 // N_i0(x) = 1 if x \in [u_i, u_i+1) 0 otherwise
 // N_ij(x) = [(x-u_i)/(u_i+j - u_i)]*N_i,j-1(x) + [(u_i+j+1 - x)/(u_i+j+1 - u_i+1)]*N_i+1,j-1(x)
+//
+// On each knot span [u_s, u_s+1) only the R+1 splines N_s-R,R, ..., N_s,R are nonzero. The routines below evaluate all
+// of them (and their derivatives) at once by unrolling the recursion bottom-up (de Boor), working directly on the knot
+// vector of the basis and without any dynamic allocation.
+
+// returns the index s of the knot span [u_s, u_s+1) containing x, or -1 if x is outside [u_R, u_m-R-1], being m the
+// size of the (padded) knot vector. The right end of the domain is assigned to the last nonempty span
+template <int R> int knot_span(const DVector<double>& knots, double x) {
+    constexpr double tol = 50 * std::numeric_limits<double>::epsilon();   // approx 10^-14
+    int m = knots.rows();
+    if (x < knots[R] || x > knots[m - R - 1] + tol) return -1;
+    if (x >= knots[m - R - 1]) return m - R - 2;
+    // binary search of the last knot u_s <= x
+    return std::upper_bound(knots.data() + R, knots.data() + m - R - 1, x) - knots.data() - 1;
+}
+
+// evaluates the R+1 splines of order R which are nonzero at x, together with their derivatives up to order K. On exit,
+// ders(k, j) = d^k/dx^k N_s-R+j,R(x), being s = knot_span<R>(knots, x) the returned index. ders is untouched if s = -1
+template <int R, int K>
+int eval_nonzero_splines(const DVector<double>& knots, double x, SMatrix<K + 1, R + 1>& ders) {
+    static_assert(K >= 0 && K <= R);
+    int s = knot_span<R>(knots, x);
+    if (s == -1) return -1;
+    std::array<std::array<double, R + 1>, R + 1> ndu;   // basis values (upper triangle) and knot differences (lower)
+    std::array<double, R + 1> left, right;
+    ndu[0][0] = 1.0;
+    for (int j = 1; j <= R; ++j) {
+        left[j] = x - knots[s + 1 - j];
+        right[j] = knots[s + j] - x;
+        double saved = 0.0;
+        for (int r = 0; r < j; ++r) {
+            ndu[j][r] = right[r + 1] + left[j - r];
+            double tmp = ndu[r][j - 1] / ndu[j][r];
+            ndu[r][j] = saved + right[r + 1] * tmp;
+            saved = left[j - r] * tmp;
+        }
+        ndu[j][j] = saved;
+    }
+    for (int j = 0; j <= R; ++j) { ders(0, j) = ndu[j][R]; }
+    if constexpr (K > 0) {
+        std::array<std::array<double, R + 1>, 2> a;
+        for (int r = 0; r <= R; ++r) {
+            int s1 = 0, s2 = 1;
+            a[0][0] = 1.0;
+            for (int k = 1; k <= K; ++k) {   // k-th derivative of N_s-R+r,R
+                double d = 0.0;
+                int rk = r - k, pk = R - k;
+                if (r >= k) {
+                    a[s2][0] = a[s1][0] / ndu[pk + 1][rk];
+                    d = a[s2][0] * ndu[rk][pk];
+                }
+                int j1 = rk >= -1 ? 1 : -rk;
+                int j2 = (r - 1 <= pk) ? k - 1 : R - r;
+                for (int j = j1; j <= j2; ++j) {
+                    a[s2][j] = (a[s1][j] - a[s1][j - 1]) / ndu[pk + 1][rk + j];
+                    d += a[s2][j] * ndu[rk + j][pk];
+                }
+                if (r <= pk) {
+                    a[s2][k] = -a[s1][k - 1] / ndu[pk + 1][r];
+                    d += a[s2][k] * ndu[r][pk];
+                }
+                ders(k, r) = d;
+                std::swap(s1, s2);
+            }
+        }
+        // multiply by the correct factors R!/(R-k)!
+        double factor = R;
+        for (int k = 1; k <= K; ++k) {
+            for (int j = 0; j <= R; ++j) { ders(k, j) *= factor; }
+            factor *= (R - k);
+        }
+    }
+    return s;
+}
 
-// A spline of order R centered in knot u_i.
-// Template parameter M is used to keep track of the order of the spline while developing the Cox-DeBoor recursion.
-template <int R, int M = R> class Spline : public ScalarExpr<1, Spline<R, M>> {
+// K-th derivative of a spline of order R
+template <int R, int K> class SplineDerivative : public ScalarExpr<1, SplineDerivative<R, K>> {
    private:
-    DVector<double> knots_ {};
-    int i_ = 0;              // knot index where this basis element is centered
-    double a_ = 0, b_ = 0;   // constants a_ = 1/(u_i+j - u_i), b_ = 1/(u_i+j+1 - u_i+1)
+    const DVector<double>* knots_ = nullptr;
+    int i_ = 0;
    public:
-    static constexpr int NestAsRef = 0;   // avoid nesting as reference, .derive() generates temporaries
-    Spline() = default;
-    Spline(const DVector<double>& knots, int i) : knots_(knots), i_(i) {
-        // avoid possible divisions by zero
-        a_ = knots_[i_ + R] - knots_[i_] != 0 ? 1.0 / (knots_[i_ + R] - knots_[i_]) : 0.0;
-        b_ = knots_[i_ + R + 1] - knots_[i_ + 1] != 0 ? 1.0 / (knots_[i_ + R + 1] - knots_[i_ + 1]) : 0.0;
-    };
-    // evaluates the spline at a given point by Cox-DeBoor recursion
+    static constexpr int NestAsRef = 0;
+    SplineDerivative() = default;
+    SplineDerivative(const DVector<double>& knots, int i) : knots_(&knots), i_(i) { }
     inline double operator()(SVector<1> x) const {
-        return a_ * (x[0] - knots_[i_]) * Spline<R - 1, M>(knots_, i_)(x) +
-               b_ * (knots_[i_ + R + 1] - x[0]) * Spline<R - 1, M>(knots_, i_ + 1)(x);
-    }
-    // compute derivative of order K as a ScalarExpr
-    // d^K/dx^K N_ij(x) = j/(u_i+j - u_i)*[d^{K-1}/dx^{K-1} N_i,j-1(x)]  - j/(u_i+j+1 - u_i+1)*
-    // [d^{K-1}/dx^{K-1} N_i+1,j-1(x)]
-    template <int K> auto derive() const {
-        if constexpr (K == 1) {   // end of recursion
-            return (R * a_) * Spline<R - 1, M>(knots_, i_) - (R * b_) * Spline<R - 1, M>(knots_, i_ + 1);
-        } else {   // exploit Cox-DeBoor recursive formula
-            return (R * a_) * Spline<R - 1, M>(knots_, i_).template derive<K - 1>() -
-                   (R * b_) * Spline<R - 1, M>(knots_, i_ + 1).template derive<K - 1>();
-        }
+        SMatrix<K + 1, R + 1> ders;
+        int s = eval_nonzero_splines<R, K>(*knots_, x[0], ders);
+        return (s == -1 || i_ < s - R || i_ > s) ? 0.0 : ders(K, i_ - s + R);
     }
 };
 
-// partial template specialization for order 0 splines (end of recursion)
-template <int M> class Spline<0, M> : public ScalarExpr<1, Spline<0, M>> {
+// A spline of order R centered in knot u_i. The spline does not own its knot vector, which is shared among all the
+// elements of a SplineBasis and must outlive it.
+template <int R> class Spline : public ScalarExpr<1, Spline<R>> {
    private:
-    DVector<double> knots_ {};
-    int i_ = 0;   // knot index where this basis is centered
-    static constexpr double tol_ = 50 * std::numeric_limits<double>::epsilon();   // approx 10^-14
+    const DVector<double>* knots_ = nullptr;
+    int i_ = 0;   // knot index where this basis element is centered
    public:
-    static constexpr int NestAsRef = 0;   // avoid nesting as reference
+    static constexpr int NestAsRef = 0;   // avoid nesting as reference, .derive() generates temporaries
     Spline() = default;
-    Spline(const DVector<double>& knots, int i) : knots_(knots), i_(i) { }
-    // indicator function over the interval [u_i, u_{i+1}). Returns 1 if at the end of the knot span.
+    Spline(const DVector<double>& knots, int i) : knots_(&knots), i_(i) { }
+    // evaluates the spline at a given point
     inline double operator()(SVector<1> x) const {
-        return (knots_[i_] <= x[0] && x[0] < knots_[i_ + 1]) ||
-               (std::abs(x[0] - knots_[knots_.rows() - 1]) < tol_ && i_ == knots_.rows() - M - 2) ? 1.0 : 0.0;
+        SMatrix<1, R + 1> ders;
+        int s = eval_nonzero_splines<R, 0>(*knots_, x[0], ders);
+        return (s == -1 || i_ < s - R || i_ > s) ? 0.0 : ders(0, i_ - s + R);
+    }
+    // compute derivative of order K as a ScalarExpr
+    template <int K> auto derive() const {
+        if constexpr (K > R) {
+            return ZeroField<1>();
+        } else {
+            return SplineDerivative<R, K>(*knots_, i_);
+        }
     }
-    // return derivative as a zero callable field
-    auto derive() const { return ZeroField<1>(); }
 };
 
 }   // namespace core
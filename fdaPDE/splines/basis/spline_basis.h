@@ -17,6 +17,9 @@
 #ifndef __SPLINE_BASIS_H__
 #define __SPLINE_BASIS_H__
 
+#include <memory>
+#include <vector>
+
 #include "../../utils/symbols.h"
 #include "../../utils/integration/integrator_tables.h"
 #include "spline.h"
@@ -24,10 +27,11 @@
 namespace fdapde {
 namespace core {
 
-// a spline basis of order R built over a given set of knots
+// a spline basis of order R built over a given set of knots. The (padded) knot vector is stored once and shared among
+// all the basis elements and the copies of this basis
 template <int R> class SplineBasis {
    private:
-    DVector<double> knots_ {};   // vector of knots
+    std::shared_ptr<DVector<double>> knots_ {};   // vector of knots
     std::vector<Spline<R>> basis_ {};
    public:
     static constexpr int order = R;
@@ -35,26 +39,26 @@ template <int R> class SplineBasis {
     typedef Integrator<SPLINE, 1, order> Quadrature;
     // constructor
     SplineBasis() = default;
-    SplineBasis(const DVector<double>& knots) : knots_(knots) {
+    SplineBasis(const DVector<double>& knots) : knots_(std::make_shared<DVector<double>>()) {
         // reserve space
         int n = knots.size();
-        knots_.resize(n + 2 * R);
+        knots_->resize(n + 2 * R);
         // pad the knot vector to obtain a full basis for the whole knot span [u_0, u_n]
         for (int i = 0; i < n + 2 * R; ++i) {
             if (i < R) {
-                knots_[i] = knots[0];
+                (*knots_)[i] = knots[0];
             } else {
                 if (i < n + R) {
-                    knots_[i] = knots[i - R];
+                    (*knots_)[i] = knots[i - R];
                 } else {
-                    knots_[i] = knots[n - 1];
+                    (*knots_)[i] = knots[n - 1];
                 }
             }
 	}
         // reserve space and compute spline basis
-        basis_.reserve(knots_.rows() - R - 1);
-        for (int k = 0; k < knots_.size() - R - 1; ++k) {
-            basis_.emplace_back(knots_, k);   // create spline centered at k-th point of knots_
+        basis_.reserve(knots_->rows() - R - 1);
+        for (int k = 0; k < knots_->size() - R - 1; ++k) {
+            basis_.emplace_back(*knots_, k);   // create spline centered at k-th point of knots_
         }
     }
 
@@ -65,16 +69,24 @@ template <int R> class SplineBasis {
     }
     const Spline<R>& operator[](int i) const { return basis_[i]; }
     int size() const { return basis_.size(); }
-    const DVector<double>& knots() const { return knots_; }
-    DMatrix<double> dofs_coords() const { return knots_.middleRows(R, knots_.rows() - R); }
+    const DVector<double>& knots() const { return *knots_; }
+    DMatrix<double> dofs_coords() const { return knots_->middleRows(R, knots_->rows() - R); }
+    // index s of the knot span [u_s, u_s+1) containing x, -1 if x is outside the domain
+    int knot_span(double x) const { return fdapde::core::knot_span<R>(*knots_, x); }
+    // evaluates the R+1 basis functions \phi_s-R, ..., \phi_s nonzero at x, together with their derivatives up to order
+    // K (ders(k, j) stores the k-th derivative of \phi_s-R+j). Returns s, -1 if x is outside the domain
+    template <int K = 0> int eval_nonzero(double x, SMatrix<K + 1, R + 1>& ders) const {
+        return eval_nonzero_splines<R, K>(*knots_, x, ders);
+    }
     // given a coefficient vector c \in \mathbb{R}^size_, evaluates the corresponding basis expansion at locs
     DVector<double> operator()(const DVector<double>& c, const DVector<double>& locs) const {
         fdapde_assert(c.rows() == size() && locs.cols() != 0);
         DVector<double> result = DVector<double>::Zero(locs.rows());
+        SMatrix<1, R + 1> psi;
         for (int i = 0; i < locs.rows(); ++i) {
-            // evaluate basis expansion \sum_{i=1}^size_ c_i \phi_i(x) at p
-            SVector<1> p(locs[i]);
-            for (int h = 0; h < basis_.size(); ++h) { result[i] += c[h] * basis_[h](p); }
+            // evaluate basis expansion \sum_{h=s-R}^s c_h \phi_h(x) at p, being s the knot span containing p
+            int s = eval_nonzero(locs[i], psi);
+            if (s != -1) result[i] = (psi * c.segment(s - R, R + 1)).value();
         }
         return result;
     }
@@ -90,15 +102,19 @@ template <int R> struct pointwise_evaluation<SplineBasis<R>> {
         SpMatrix<double> Phi(locs.rows(), n_basis);
         std::vector<fdapde::Triplet<double>> triplet_list;
         triplet_list.reserve(locs.rows() * (R + 1));
-        // build \Phi matrix
-        for (int i = 0; i < n_basis; ++i) {
-            for (int j = 0; j < locs.rows(); ++j) { triplet_list.emplace_back(j, i, basis[i](SVector<1>(locs[j]))); }
+        // build \Phi matrix, only the R+1 splines nonzero on the knot span of each location are evaluated
+        SMatrix<1, R + 1> psi;
+        for (int i = 0; i < locs.rows(); ++i) {
+            int s = basis.eval_nonzero(locs[i], psi);
+            if (s == -1) continue;   // location outside the domain
+            for (int h = 0; h <= R; ++h) {
+                if (psi[h] != 0.0) triplet_list.emplace_back(i, s - R + h, psi[h]);
+            }
         }
         // finalize construction
         Phi.setFromTriplets(triplet_list.begin(), triplet_list.end());
-        Phi.prune(0.0);   // remove zeros
         Phi.makeCompressed();
-        return std::pair(std::move(Phi), DVector<double>::Ones(locs.rows()));;
+        return std::pair(std::move(Phi), DVector<double>::Ones(locs.rows()));
     }
 };
 
@@ -19,6 +19,7 @@
 
 #include <exception>
 
+#include "../../linear_algebra/banded_lu.h"
 #include "../../utils/symbols.h"
 #include "spline_solver_base.h"
 
@@ -35,8 +36,8 @@ struct SplineLinearEllipticSolver : public SplineSolverBase<D, E, F, Ts...> {
         fdapde_static_assert(is_pde<PDE>::value, THIS_METHOD_IS_FOR_PDE_ONLY);
         if (!this->is_init) throw std::runtime_error("solver must be initialized first!");
 
-        typedef Eigen::SparseLU<SpMatrix<double>, Eigen::COLAMDOrdering<int>> SystemSolverType;
-        SystemSolverType solver;
+        // stiff matrix is banded with bandwidth equal to the spline order, solve by banded LU in O(n_dofs * order^2)
+        BandedLU<double> solver;
         solver.compute(this->stiff_);
         // stop if something was wrong
         if (solver.info() != Eigen::Success) {
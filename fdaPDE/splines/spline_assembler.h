@@ -39,11 +39,12 @@ template <typename D, typename B, typename I> class Assembler<SPLINE, D, B, I> {
     template <typename E> SpMatrix<double> discretize_operator(const E& op) {
         constexpr int R = B::order;
         std::size_t M = basis_.size();
+        const DVector<double>& knots = basis_.knots();
         std::vector<fdapde::Triplet<double>> triplet_list;
         SpMatrix<double> discretization_matrix;
 
-        // properly preallocate memory to avoid reallocations
-        triplet_list.reserve(M * M);
+        // properly preallocate memory to avoid reallocations (each knot span contributes with a (R+1)^2 block)
+        triplet_list.reserve((knots.rows() - 2 * R - 1) * (R + 1) * (R + 1));
         discretization_matrix.resize(M, M);
 
         // prepare space for bilinear form components
@@ -52,22 +53,21 @@ template <typename D, typename B, typename I> class Assembler<SPLINE, D, B, I> {
         // prepare buffer to be sent to bilinear form
         auto mem_buffer = std::make_tuple(ScalarPtr(&buff_psi_i), ScalarPtr(&buff_psi_j));
 
-        // start assembly loop (exploit local support of spline basis)
-        for (std::size_t i = 0; i < M; ++i) {
-            buff_psi_i = basis_[i];
-            for (std::size_t j = 0; j <= (E::is_symmetric ? i : M); ++j) {
-                buff_psi_j = basis_[j];
-                auto f = op.integrate(mem_buffer);   // let the compiler deduce the type of the expression template!
-
-                // perform integration of f over interval [knots[j], knots[i+R+1]]
-                double value = 0;
-                for (std::size_t k = j; k <= i + R; ++k) {
-                    value += integrator_.template integrate<decltype(f)>(basis_.knots()[k], basis_.knots()[k + 1], f);
+        // start assembly loop over knot spans. Only \psi_k-R, ..., \psi_k are nonzero on [u_k, u_k+1)
+        for (int k = R; k < knots.rows() - R - 1; ++k) {
+            if (knots[k] == knots[k + 1]) continue;   // empty span
+            for (int h = 0; h <= R; ++h) {
+                buff_psi_i = basis_[k - R + h];
+                for (int l = 0; l <= (E::is_symmetric ? h : R); ++l) {
+                    buff_psi_j = basis_[k - R + l];
+                    auto f = op.integrate(mem_buffer);   // let the compiler deduce the type of the expression template!
+                    // perform integration of f over interval [knots[k], knots[k+1]]
+                    triplet_list.emplace_back(
+                      k - R + h, k - R + l, integrator_.template integrate<decltype(f)>(knots[k], knots[k + 1], f));
                 }
-                triplet_list.emplace_back(i, j, value);
             }
         }
-        // finalize construction
+        // finalize construction (contributions of different spans to the same entry are summed up)
         discretization_matrix.setFromTriplets(triplet_list.begin(), triplet_list.end());
         discretization_matrix.makeCompressed();
 
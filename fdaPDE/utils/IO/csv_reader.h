@@ -17,6 +17,7 @@
 #ifndef __CSV_READER_H__
 #define __CSV_READER_H__
 
+#include <algorithm>
 #include <fstream>
 #include <limits>
 #include <sstream>
@@ -71,6 +72,23 @@ class CSVReader{
  public:
   CSVReader() = default;
 
+  // parses a line of a dense .csv file into the row-th row of m
+  void parse_line(const std::string& line, DMatrix<T>& m, int row) const {
+    // split CSV line in tokens
+    std::vector<std::string> parsed_line = split_string(line, ",");
+    for(std::size_t col = 1; col < parsed_line.size(); ++col){ // skip first column (row index column)
+      std::string data_token = remove_char(parsed_line[col], filter_);
+      // detect token type
+      auto token_type = reserved_tokens_.find(data_token);
+      if(token_type != reserved_tokens_.end()) { // reserved token found
+	m(row, col-1) = token_type->second;
+      } else {
+	std::istringstream ss(data_token);
+	ss >> m(row, col-1);
+      }
+    }
+  }
+
   // parse files with a dense structure
   template <typename U>
   typename std::enable_if<std::is_same<U, Eigen::Dense>::value, DMatrix<T>>::type
@@ -96,19 +114,7 @@ class CSVReader{
     // read file until EOF
     int row = 0;
     while(getline(file_stream, line)){
-      // split CSV line in tokens
-      std::vector<std::string> parsed_line = split_string(line, ",");
-      for(std::size_t col = 1; col < parsed_line.size(); ++col){ // skip first column (row index column)
-	std::string data_token = remove_char(parsed_line[col], filter_);
-	// detect token type
-	auto token_type = reserved_tokens_.find(data_token);
-	if(token_type != reserved_tokens_.end()) { // reserved token found
-	  parsed_file(row, col-1) = token_type->second;
-	} else {
-	  std::istringstream ss(data_token);
-	  ss >> parsed_file(row, col-1);
-	}
-      }
+      parse_line(line, parsed_file, row);
       row++;
     }
     // close file and return
@@ -166,6 +172,37 @@ class CSVReader{
   }
 };
 
+// reads a file with a dense structure in blocks of rows, keeping in memory at most one block at a time
+template <typename T>
+class CSVChunkReader{
+ private:
+  CSVReader<T> reader_ {};
+  std::ifstream file_stream_;
+  int cols_ = 0;
+  int chunk_size_ = 0;
+ public:
+  CSVChunkReader(const std::string& file, int chunk_size) : file_stream_(file), chunk_size_(chunk_size) {
+    if(!file_stream_) { throw std::runtime_error("unable to open file " + file); }
+    std::string line;
+    getline(file_stream_, line); // read first line
+    cols_ = std::count(line.begin(), line.end(), ','); // first column is row index column
+  }
+  // parses the next (at most) chunk_size rows in chunk, returns false if there is nothing left to read
+  bool next(DMatrix<T>& chunk) {
+    chunk.resize(chunk_size_, cols_);
+    std::string line;
+    int row = 0;
+    while(row < chunk_size_ && getline(file_stream_, line)){
+      if(line.empty()) continue;
+      reader_.parse_line(line, chunk, row);
+      row++;
+    }
+    chunk.conservativeResize(row, cols_);
+    return row != 0;
+  }
+  int cols() const { return cols_; }
+};
+
 }}
   
 #endif // __CSV_READER_H__
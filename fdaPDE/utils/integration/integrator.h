@@ -17,6 +17,7 @@
 #ifndef __INTEGRATOR_H__
 #define __INTEGRATOR_H__
 
+#include "../../geometry/cell_traversal.h"
 #include "../../geometry/triangulation.h"
 #include "../../geometry/interval.h"
 #include "../../fields/scalar_expressions.h"
@@ -59,13 +60,14 @@ template <int LocalDim, int Order> class Integrator<FEM, LocalDim, Order> {
         return value * e.measure();
     }
     // integrate a callable F over a mesh m
+    template <typename MeshType, typename ExprType, typename Policy>
+    double integrate(const MeshType& m, const ExprType& f, const Policy& policy) const
+        requires(is_execution_policy<Policy>::value) {
+        return transform_reduce_cells(
+          m, policy, 0.0, [&](const typename MeshType::CellType& e) { return integrate_cell(e, f); }, std::plus<>());
+    }
     template <typename MeshType, typename ExprType> double integrate(const MeshType& m, const ExprType& f) const {
-        double value = 0;
-        // cycle over all mesh elements
-        for (typename MeshType::cell_iterator it = m.cells_begin(); it != m.cells_end(); ++it) {
-            value += integrate_cell(*it, f);
-        }
-        return value;
+        return integrate(m, f, execution::default_policy());
     }
     // perform integration of \int_e [f * \phi] using a basis system defined over the reference element and the change
     // of variables formula: \int_e [f(x) * \phi(x)] = \int_{E} [f(J(X)) * \Phi(X)] |detJ| where J is the affine mapping
@@ -88,6 +90,30 @@ template <int LocalDim, int Order> class Integrator<FEM, LocalDim, Order> {
         // correct for measure of domain (element e)
         return value * e.measure();
     }
+    // tabulates a basis system defined over the reference element at the quadrature nodes, [Phi]_{iq,i} = \phi_i(p_iq)
+    template <typename BasisType>
+    Eigen::Matrix<double, num_nodes_, BasisType::n_basis> tabulate(const BasisType& basis) const {
+        DMatrix<double> nodes(num_nodes_, LocalDim);
+        for (size_t iq = 0; iq < num_nodes_; ++iq) { nodes.row(iq) = integration_table_.nodes[iq].transpose(); }
+        return basis.eval(nodes);
+    }
+    // computes \int_e [f * \phi_i] for all the basis functions at once, given their tabulation Phi at the quadrature
+    // nodes (see tabulate()). Equivalent to integrate(e, f, \phi_i) for each i, but f is evaluated once per node
+    template <typename CellType, typename ExprType, int K>
+    SVector<K> integrate(const CellType& e, const ExprType& f, const Eigen::Matrix<double, num_nodes_, K>& Phi) const {
+        SVector<K> value = SVector<K>::Zero();
+        for (size_t iq = 0; iq < num_nodes_; ++iq) {
+            double f_iq;
+            if constexpr (std::is_base_of<ScalarExpr<CellType::embed_dim, ExprType>, ExprType>::value) {
+                SVector<CellType::embed_dim> Jp = e.J() * integration_table_.nodes[iq] + e.node(0);
+                f_iq = f(Jp);
+            } else {
+                f_iq = f(num_nodes_ * e.id() + iq, 0);
+            }
+            for (int i = 0; i < K; ++i) { value[i] += (f_iq * Phi(iq, i)) * integration_table_.weights[iq]; }
+        }
+        return value * e.measure();
+    }
     // integrate the weak form of operator L to produce its (i,j)-th discretization matrix element
     template <typename L, typename CellType, typename ExprType>
     double integrate_weak_form(const CellType& e, ExprType& f) const {
@@ -109,14 +135,13 @@ template <int LocalDim, int Order> class Integrator<FEM, LocalDim, Order> {
     template <typename MeshType> DMatrix<double> quadrature_nodes(const MeshType& m) const {
         DMatrix<double> quadrature_nodes;
         quadrature_nodes.resize(m.n_cells() * num_nodes_, MeshType::embed_dim);
-        // cycle over all mesh elements
-        for (typename MeshType::cell_iterator it = m.cells_begin(); it != m.cells_end(); ++it) {
+        for_each_cell(m, [&](const typename MeshType::CellType& e) {
             // for each quadrature node, map it onto the physical element e and store it
             for (size_t iq = 0; iq < num_nodes_; ++iq) {
-                quadrature_nodes.row(num_nodes_ * it->id() + iq) =
-                  it->J() * SVector<LocalDim>(integration_table_.nodes[iq].data()) + it->node(0);
+                quadrature_nodes.row(num_nodes_ * e.id() + iq) =
+                  e.J() * SVector<LocalDim>(integration_table_.nodes[iq].data()) + e.node(0);
             }
-        }
+        });
         return quadrature_nodes;
     }
     std::size_t num_nodes() const { return num_nodes_; }
@@ -144,27 +169,25 @@ template <int Order> class Integrator<SPLINE, 1, Order> {
         return integrate(e.node(0), e.node(1), f);
     }
     // integrate a callable F over a 1D Mesh
+    template <typename ExprType, typename Policy>
+    double integrate(const MeshType& m, const ExprType& f, const Policy& policy) const {
+        return transform_reduce_cells(
+          m, policy, 0.0, [&](const typename MeshType::CellType& e) { return integrate(e, f); }, std::plus<>());
+    }
     template <typename ExprType> double integrate(const MeshType& m, const ExprType& f) const {
-        double value = 0;
-        // cycle over all mesh elements
-        for (typename MeshType::cell_iterator it = m.cells_begin(); it != m.cells_end(); ++it) {
-            value += integrate(*it, f);
-	}
-        return value;
+        return integrate(m, f, execution::default_policy());
     }
     // getters
     DMatrix<double> quadrature_nodes(const MeshType& m) const {
         DMatrix<double> quadrature_nodes;
         quadrature_nodes.resize(m.n_cells() * num_nodes_, 1);
-        // cycle over all mesh elements
-        for (typename MeshType::cell_iterator it = m.cells_begin(); it != m.cells_end(); ++it) {
+        for_each_cell(m, [&](const typename MeshType::CellType& e) {
             // for each quadrature node, map it onto the physical element e and store it
             for (size_t iq = 0; iq < num_nodes_; ++iq) {
-                quadrature_nodes.row(num_nodes_ * it->id() + iq) =
-                  ((it->node(1) - it->node(0)) / 2) * integration_table_.nodes[iq][0] +
-                  ((it->node(1) + it->node(0)) / 2);
+                quadrature_nodes.row(num_nodes_ * e.id() + iq) =
+                  ((e.node(1) - e.node(0)) / 2) * integration_table_.nodes[iq][0] + ((e.node(1) + e.node(0)) / 2);
             }
-        }
+        });
         return quadrature_nodes;
     }
     std::size_t num_nodes() const { return num_nodes_; }
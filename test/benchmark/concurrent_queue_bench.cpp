@@ -0,0 +1,108 @@
+// This file is part of fdaPDE, a C++ library for physics-informed
+// spatial and functional data analysis.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+// throughput of ConcurrentQueue against a mutex guarded std::queue, for an increasing number of producers and
+// consumers. Each producer pushes n_items / n_producers integers, consumers pop until all items are extracted.
+// usage: concurrent_queue_bench [n_items]
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include <fdaPDE/multithreading.h>
+using fdapde::core::ConcurrentQueue;
+
+// reference implementation, a std::queue guarded by a mutex
+template <typename T> class LockedQueue {
+   private:
+    std::queue<T> queue_;
+    std::mutex mutex_;
+   public:
+    bool try_push(const T& value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push(value);
+        return true;
+    }
+    bool pop(T& buff) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queue_.empty()) return false;
+        buff = queue_.front();
+        queue_.pop();
+        return true;
+    }
+};
+
+// returns the throughput in millions of items per second
+template <typename Queue> double run(Queue& queue, int n_producers, int n_consumers, long n_items) {
+    std::atomic<long> consumed = 0;
+    std::atomic<long long> checksum = 0;
+    std::atomic<bool> start = false;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < n_producers; ++p) {
+        threads.emplace_back([&, p]() {
+            while (!start.load()) std::this_thread::yield();
+            for (long i = p; i < n_items; i += n_producers) {
+                while (!queue.try_push(static_cast<int>(i))) std::this_thread::yield();
+            }
+        });
+    }
+    for (int c = 0; c < n_consumers; ++c) {
+        threads.emplace_back([&]() {
+            while (!start.load()) std::this_thread::yield();
+            long long sum = 0;
+            int value;
+            while (consumed.load(std::memory_order_relaxed) < n_items) {
+                if (queue.pop(value)) {
+                    sum += value;
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            checksum.fetch_add(sum);
+        });
+    }
+    auto t0 = std::chrono::steady_clock::now();
+    start = true;
+    for (std::thread& t : threads) t.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - t0;
+    if (checksum.load() != static_cast<long long>(n_items) * (n_items - 1) / 2) {
+        std::cerr << "checksum mismatch" << std::endl;
+        std::exit(1);
+    }
+    return n_items / elapsed.count() / 1e6;
+}
+
+int main(int argc, char** argv) {
+    long n_items = argc > 1 ? std::atol(argv[1]) : 2000000;
+    std::cout << "threads (producers = consumers), mutex queue [Mitems/s], lock-free queue [Mitems/s]" << std::endl;
+    for (int n = 1; n <= 64; n *= 2) {
+        LockedQueue<int> locked_queue;
+        ConcurrentQueue<int> lock_free_queue(4096);
+        double locked = run(locked_queue, n, n, n_items);
+        double lock_free = run(lock_free_queue, n, n, n_items);
+        std::cout << std::setw(3) << n << std::fixed << std::setprecision(2) << std::setw(12) << locked
+                  << std::setw(12) << lock_free << std::endl;
+    }
+    return 0;
+}
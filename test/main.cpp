@@ -46,6 +46,10 @@ using namespace Eigen::placeholders;
 #include "src/kronecker_product_test.cpp"
 #include "src/vector_space_test.cpp"
 #include "src/binary_matrix_test.cpp"
+#include "src/sparse_block_matrix_test.cpp"
+#include "src/fspai_test.cpp"
+// multithreading
+#include "src/thread_pool_test.cpp"
 // finite_elements
 #include "src/fem_operators_test.cpp"
 #include "src/fem_pde_test.cpp"
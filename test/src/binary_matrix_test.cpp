@@ -329,3 +329,28 @@ TEST(binary_matrix_test, reshaped) {
     m4.row(99).set();
     EXPECT_TRUE(m3 == m4);
 }
+
+TEST(binary_matrix_test, set_bit_scanning) {
+    // a vector spanning several bitpacks, with padding bits set in the last one
+    BinaryVector<Dynamic> v = BinaryVector<Dynamic>::Ones(150);
+    EXPECT_TRUE(v.count() == 150);
+    EXPECT_TRUE(v.find_next(149) == 149 && v.find_next(150) == 150);
+    BinaryVector<Dynamic> w(150);
+    EXPECT_TRUE(w.find_next(0) == 150 && w.find_prev(149) == -1);
+    std::vector<int> ids = {0, 5, 63, 64, 100, 149};
+    for (int i : ids) w.set(i);
+    EXPECT_TRUE(w.count() == 6);
+    EXPECT_TRUE(w.which(true) == ids);
+    // forward and backward scans agree with a bit by bit visit
+    for (int i = 0; i <= 150; ++i) {
+        int next = i, prev = i - 1;
+        for (; next < 150 && !w[next]; ++next);
+        for (; prev >= 0 && !w[prev]; --prev);
+        EXPECT_TRUE(w.find_next(i) == next);
+        EXPECT_TRUE(w.find_prev(i - 1) == prev);
+    }
+    // scan of a binary expression
+    auto e = ~w & v;
+    EXPECT_TRUE(e.find_next(63) == 65 && e.find_prev(64) == 62);
+    EXPECT_TRUE(e.count() == 144);
+}
@@ -366,3 +366,90 @@ TEST(fem_pde_test, parabolic_isotropic_order1_convergence) {
         EXPECT_TRUE(floor(order(n - 1)) == 2);
     }
 }
+
+// check that the lumped mass matrix assembled cell by cell coincides with the row-sum lumping of the consistent mass
+// matrix, and that the parabolic solver keeps its accuracy when run with a lumped mass
+TEST(fem_pde_test, parabolic_isotropic_order1_mass_lumping) {
+    constexpr double pi = 3.14159265358979323846;
+    int M = 31;
+    DMatrix<double> times(M, 1);
+    double time_max = 1.;
+    for (int j = 0; j < M; ++j) { times(j) = time_max / (M - 1) * j; }
+    auto solution_expr = [](SVector<2> x, double t) -> double {
+        return std::sin(2 * pi * x[0]) * std::sin(2 * pi * x[1]) * std::exp(-t);
+    };
+    auto forcing_expr = [](SVector<2> x, double t) -> double {
+        return (8 * pi * pi - 1.) * std::sin(2 * pi * x[0]) * std::sin(2 * pi * x[1]) * std::exp(-t);
+    };
+
+    MeshLoader<Triangulation<2, 2>> unit_square("unit_square_32");
+    auto L = dt<FEM>() - laplacian<FEM>();
+    using PDEType = PDE<decltype(unit_square.mesh), decltype(L), DMatrix<double>, FEM, fem_order<1>>;
+    DVector<double> error_L2(2);
+    SpMatrix<double> mass[2];
+    for (int k = 0; k < 2; ++k) {
+        PDEType pde_(unit_square.mesh, times, L);
+        pde_.set_mass_lumping(k == 1);
+        DMatrix<double> nodes_ = pde_.dof_coords();
+        DMatrix<double> dirichlet_bc(nodes_.rows(), M);
+        DMatrix<double> initial_condition(nodes_.rows(), 1);
+        for (int i = 0; i < nodes_.rows(); ++i) {
+            for (int j = 0; j < M; ++j) { dirichlet_bc(i, j) = solution_expr(nodes_.row(i), times(j)); }
+            initial_condition(i) = solution_expr(nodes_.row(i), times(0));
+        }
+        pde_.set_dirichlet_bc(dirichlet_bc);
+        pde_.set_initial_condition(initial_condition);
+        DMatrix<double> quadrature_nodes = pde_.quadrature_nodes();
+        DMatrix<double> f(quadrature_nodes.rows(), M);
+        for (int i = 0; i < quadrature_nodes.rows(); ++i) {
+            for (int j = 0; j < M; ++j) { f(i, j) = forcing_expr(quadrature_nodes.row(i), times(j)); }
+        }
+        pde_.set_forcing(f);
+        pde_.init();
+        pde_.solve();
+        mass[k] = pde_.mass();
+        DMatrix<double> error_ = dirichlet_bc.col(M - 1) - pde_.solution().col(M - 1);
+        error_L2[k] = std::sqrt((mass[0] * error_.cwiseProduct(error_)).sum());
+    }
+    // lumped mass is diagonal and equals the row sums of the consistent mass (also if only a triangle is stored)
+    EXPECT_TRUE(mass[1].nonZeros() == mass[1].rows());
+    EXPECT_TRUE((mass[1] - fdapde::core::lump(mass[0])).norm() < DOUBLE_TOLERANCE);
+    SpMatrix<double> lower_mass = mass[0].triangularView<Eigen::Lower>();
+    EXPECT_TRUE(
+      (mass[1] - fdapde::core::lump(lower_mass.selfadjointView<Eigen::Lower>())).norm() < DOUBLE_TOLERANCE);
+    // lumping perturbs the solution at most by a quantity comparable to the discretization error
+    EXPECT_TRUE(error_L2[1] < 2 * error_L2[0]);
+}
+
+// check that assembly is independent of the execution policy driving the traversal of the mesh
+TEST(fem_pde_test, assembly_execution_policy) {
+    namespace execution = fdapde::core::execution;
+    MeshLoader<Triangulation<2, 2>> unit_square("unit_square");
+    auto L = -laplacian<FEM>();
+    auto assemble = [&](const execution::any_policy& policy) {
+        execution::set_default_policy(policy);
+        PDE<decltype(unit_square.mesh), decltype(L), DMatrix<double>, FEM, fem_order<2>> pde_(unit_square.mesh, L);
+        DMatrix<double> quadrature_nodes = pde_.quadrature_nodes();
+        DMatrix<double> f(quadrature_nodes.rows(), 1);
+        for (int i = 0; i < quadrature_nodes.rows(); ++i) { f(i, 0) = std::sin(quadrature_nodes(i, 0)); }
+        pde_.set_forcing(f);
+        pde_.init();
+        return std::make_tuple(pde_.stiff(), DMatrix<double>(pde_.force()), quadrature_nodes);
+    };
+    auto [A_seq, b_seq, q_seq] = assemble(execution::sequential_policy {});
+    // triplets and local forcing terms are summed up in cell order, results are bit-identical whatever the number of
+    // chunks and of threads
+    std::vector<execution::any_policy> policies = {execution::chunked_policy {4}, execution::threaded_policy {64}};
+    std::vector<std::unique_ptr<fdapde::core::ThreadPool>> pools;
+    for (int n_threads : {1, 2, 8, 32}) {
+        pools.push_back(std::make_unique<fdapde::core::ThreadPool>(n_threads));
+        policies.push_back(execution::reproducible_policy {64, pools.back().get()});
+    }
+    for (const auto& policy : policies) {
+        auto [A, b, q] = assemble(policy);
+        EXPECT_TRUE(SpMatrix<double>(A_seq - A).norm() == 0);
+        EXPECT_TRUE(b_seq == b);
+        EXPECT_TRUE(q_seq == q);
+    }
+    execution::set_default_policy(execution::sequential_policy {});
+}
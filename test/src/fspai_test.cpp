@@ -0,0 +1,74 @@
+// This file is part of fdaPDE, a C++ library for physics-informed
+// spatial and functional data analysis.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <gtest/gtest.h>   // testing framework
+#include <cstddef>
+
+#include <fdaPDE/linear_algebra.h>
+using fdapde::core::FSPAI;
+
+#include "utils/utils.h"
+using fdapde::testing::almost_equal;
+
+// weighted 5-point laplacian on a n x n grid, shifted by the identity
+SpMatrix<double> shifted_laplacian(int n) {
+    std::vector<fdapde::Triplet<double>> triplet_list;
+    DVector<double> diag = DVector<double>::Ones(n * n);
+    auto add_edge = [&](int a, int b) {
+        double w = 0.5 + ((std::min(a, b) * 7 + std::max(a, b) * 13) % 10) / 10.0;   // symmetric weight
+        triplet_list.emplace_back(a, b, -w);
+        diag[a] += w;
+    };
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            int id = i * n + j;
+            if (i > 0) add_edge(id, id - n);
+            if (i < n - 1) add_edge(id, id + n);
+            if (j > 0) add_edge(id, id - 1);
+            if (j < n - 1) add_edge(id, id + 1);
+        }
+    }
+    for (int i = 0; i < n * n; ++i) { triplet_list.emplace_back(i, i, diag[i]); }
+    SpMatrix<double> A(n * n, n * n);
+    A.setFromTriplets(triplet_list.begin(), triplet_list.end());
+    return A;
+}
+
+TEST(fspai_test, approximate_inverse_factor) {
+    SpMatrix<double> A = shifted_laplacian(20);
+    FSPAI fspai(A);
+    fspai.compute(5, 3, 1e-8, 1);
+    SpMatrix<double> L = fspai.getL();
+    // L is lower triangular and L^\top*A*L has unit diagonal
+    for (int k = 0; k < L.outerSize(); ++k) {
+        for (SpMatrix<double>::InnerIterator it(L, k); it; ++it) { EXPECT_TRUE(it.row() >= it.col()); }
+    }
+    DVector<double> d = SpMatrix<double>(L.transpose() * A * L).diagonal();
+    EXPECT_TRUE(almost_equal(DMatrix<double>(d), DMatrix<double>(DVector<double>::Ones(d.rows()))));
+    // pattern updates improve the K-condition number of L^\top*A*L wrt the diagonal (Jacobi) preconditioner
+    FSPAI jacobi(A);
+    jacobi.compute(1, 3, 1e-8, 1);
+    // since diag(L^\top*A*L) = I, the K-condition number of L^\top*A*L is 1/det(L^\top*A*L)
+    auto log_K_condition_number = [&A](const SpMatrix<double>& L) {
+        Eigen::LLT<DMatrix<double>> llt(DMatrix<double>(L.transpose() * A * L));
+        return -2 * llt.matrixLLT().diagonal().array().log().sum();
+    };
+    EXPECT_TRUE(log_K_condition_number(L) < log_K_condition_number(jacobi.getL()));
+    // parallel computation gives the same result
+    FSPAI fspai_mt(A);
+    fspai_mt.compute(5, 3, 1e-8, 4);
+    EXPECT_TRUE(almost_equal(fspai_mt.getL(), L));
+}
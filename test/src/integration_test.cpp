@@ -79,6 +79,32 @@ TEST(integration_test, integrate_over_triangulation) {
     EXPECT_TRUE(almost_equal(1.0, integrator.integrate(CShaped.mesh, f)));
 }
 
+// test if integration over the mesh is independent of the execution policy
+TEST(integration_test, integrate_execution_policy) {
+    namespace execution = fdapde::core::execution;
+    MeshLoader<Triangulation<2, 2>> CShaped("c_shaped");
+    Integrator<FEM, 2, 1> integrator {};
+    std::function<double(SVector<2>)> f = [](SVector<2> x) -> double { return std::exp(x[0]) * x[1]; };
+    double value = integrator.integrate(CShaped.mesh, f, execution::seq);
+    EXPECT_TRUE(almost_equal(value, integrator.integrate(CShaped.mesh, f, execution::par)));
+    EXPECT_TRUE(almost_equal(value, integrator.integrate(CShaped.mesh, f, execution::chunked_policy {7})));
+}
+
+// test if integration over the mesh under the reproducible policy is bit-identical whatever the number of threads
+TEST(integration_test, integrate_reproducible) {
+    namespace execution = fdapde::core::execution;
+    MeshLoader<Triangulation<2, 2>> unit_square("unit_square");
+    Integrator<FEM, 2, 1> integrator {};
+    std::function<double(SVector<2>)> f = [](SVector<2> x) -> double { return std::exp(x[0]) * std::sin(10 * x[1]); };
+    std::vector<double> values;
+    for (int n_threads : {1, 2, 8, 32}) {
+        fdapde::core::ThreadPool pool(n_threads);
+        values.push_back(integrator.integrate(unit_square.mesh, f, execution::reproducible_policy {64, &pool}));
+    }
+    for (double value : values) { EXPECT_TRUE(value == values[0]); }
+    EXPECT_TRUE(almost_equal(values[0], integrator.integrate(unit_square.mesh, f, execution::seq)));
+}
+
 // test correctness of integrator tables
 template <typename E> struct quadrature_rules_test : public ::testing::Test {
     static constexpr unsigned int M = E::value;
@@ -19,6 +19,7 @@
 
 #include <fdaPDE/linear_algebra.h>
 using fdapde::core::Kronecker;
+using fdapde::core::KroneckerSolver;
 
 #include "utils/utils.h"
 using fdapde::testing::almost_equal;
@@ -145,3 +146,50 @@ TEST(kronecker_product_test, sparse_sparse_rectangular) {
         }
     }
 }
+
+TEST(kronecker_product_test, structured_matvec) {
+    // sparse operands
+    SpMatrix<double> A = DMatrix<double>::Random(4, 3).sparseView(0.5, 1.0);
+    SpMatrix<double> B = DMatrix<double>::Random(5, 6).sparseView(0.5, 1.0);
+    DMatrix<double> x = DMatrix<double>::Random(3 * 6, 2);
+    SpMatrix<double> kron_sparse = Kronecker(A, B);
+    EXPECT_TRUE(almost_equal(DMatrix<double>(Kronecker(A, B) * x), DMatrix<double>(kron_sparse * x)));
+    // dense operands
+    DMatrix<double> C = DMatrix<double>::Random(4, 3), D = DMatrix<double>::Random(5, 6);
+    DMatrix<double> kron_dense = Kronecker(C, D);
+    EXPECT_TRUE(almost_equal(DMatrix<double>(Kronecker(C, D) * x), DMatrix<double>(kron_dense * x)));
+}
+
+TEST(kronecker_product_test, structured_solve) {
+    // sparse operands
+    SpMatrix<double> A = DMatrix<double>(DMatrix<double>::Random(4, 4) + 4 * DMatrix<double>::Identity(4, 4)).sparseView();
+    SpMatrix<double> B = DMatrix<double>(DMatrix<double>::Random(5, 5) + 5 * DMatrix<double>::Identity(5, 5)).sparseView();
+    DMatrix<double> x = DMatrix<double>::Random(20, 2);
+    SpMatrix<double> kron_sparse = Kronecker(A, B);
+    KroneckerSolver<Eigen::SparseLU<SpMatrix<double>>> sparse_solver(Kronecker(A, B));
+    EXPECT_TRUE(sparse_solver.info() == Eigen::Success);
+    EXPECT_TRUE(almost_equal(sparse_solver.solve(kron_sparse * x), x));
+    // dense operands
+    DMatrix<double> C = DMatrix<double>(A), D = DMatrix<double>(B);
+    KroneckerSolver<Eigen::PartialPivLU<DMatrix<double>>> dense_solver(C, D);
+    EXPECT_TRUE(almost_equal(dense_solver.solve(Kronecker(C, D) * x), x));
+}
+
+TEST(kronecker_product_test, sparse_sparse_parallel_materialization) {
+    // random sparse operands, with some empty rows and columns
+    SpMatrix<double> A = DMatrix<double>::Random(40, 30).sparseView(0.7, 1.0);
+    SpMatrix<double> B = DMatrix<double>::Random(25, 35).sparseView(0.7, 1.0);
+    B.uncompress();
+    DMatrix<double> expected = Kronecker(DMatrix<double>(A), DMatrix<double>(B));
+    // assignment from the Kronecker expression
+    SpMatrix<double> kron = Kronecker(A, B);
+    EXPECT_TRUE(kron.isCompressed() && kron.nonZeros() == A.nonZeros() * B.nonZeros());
+    EXPECT_TRUE(almost_equal(DMatrix<double>(kron), expected));
+    // multithreaded kernel
+    SpMatrix<double> kron_mt;
+    fdapde::core::kronecker_product_sparse(A, B, kron_mt, 4);
+    EXPECT_TRUE(almost_equal(DMatrix<double>(kron_mt), expected));
+    // aliasing
+    A = Kronecker(A, B);
+    EXPECT_TRUE(almost_equal(DMatrix<double>(A), expected));
+}
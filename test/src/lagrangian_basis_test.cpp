@@ -18,6 +18,8 @@
 #include <cstddef>
 #include <limits>
 #include <string>
+#include <filesystem>
+#include <fstream>
 #include <type_traits>
 
 #include <fdaPDE/utils.h>
@@ -33,6 +35,7 @@ using fdapde::core::Integrator;
 using fdapde::core::VectorField;
 using fdapde::core::IntegratorTable;
 using fdapde::core::Triangulation;
+using fdapde::core::streaming_gram;
 
 #include "utils/constants.h"
 using fdapde::testing::DOUBLE_TOLERANCE;
@@ -100,6 +103,29 @@ TYPED_TEST(lagrangian_basis_test, reference_element_support) {
     }
 }
 
+// tests batch evaluation of the basis (and its gradient) over a set of points agrees with pointwise evaluation
+TYPED_TEST(lagrangian_basis_test, batch_evaluation) {
+    constexpr int N = TestFixture::N;
+    auto basis = LagrangianBasis<Triangulation<N, N>, TestFixture::R>::ref_basis();
+    DMatrix<double> points = (DMatrix<double>::Random(37, N).array() + 1.0) / 2;   // points in [0,1]^N
+    DMatrix<double> psi = basis.eval(points);
+    std::array<DMatrix<double>, N> grad_psi = basis.eval_grad(points);
+    EXPECT_TRUE(psi.rows() == points.rows() && psi.cols() == TestFixture::n_basis);
+    for (int j = 0; j < basis.size(); ++j) {
+        DVector<double> values = basis[j].eval(points);
+        DMatrix<double> grad = basis[j].eval_grad(points);
+        for (int i = 0; i < points.rows(); ++i) {
+            SVector<N> p = points.row(i).transpose();
+            SVector<N> expected_grad = basis[j].derive()(p);
+            EXPECT_TRUE(almost_equal(psi(i, j), basis[j](p)) && almost_equal(values[i], basis[j](p)));
+            for (int k = 0; k < N; ++k) {
+                EXPECT_TRUE(almost_equal(grad_psi[k](i, j), expected_grad[k]));
+                EXPECT_TRUE(almost_equal(grad(i, k), expected_grad[k]));
+            }
+        }
+    }
+}
+
 // test linear elements behave correctly on reference element
 TEST(lagrangian_basis_test, order1_reference_element) {
     // create finite linear elements over unit reference simplex
@@ -237,3 +263,117 @@ TEST(lagrangian_basis_test, order2_areal_evaluation) {
     EXPECT_TRUE(almost_equal(res.first, "../data/mtx/lagrangian_areal_eval_order2.mtx"));
 }
 
+
+// evaluate several basis expansions at the same set of locations using a cached evaluation plan
+TEST(lagrangian_basis_test, order2_evaluation_plan) {
+    MeshLoader<Triangulation<2, 2>> domain("c_shaped");
+    LagrangianBasis<Triangulation<2, 2>, 2> basis(domain.mesh);
+    DMatrix<double> locs = read_csv<double>("../data/mesh/c_shaped/locs.csv");
+    auto plan = basis.evaluation_plan(locs);
+    EXPECT_TRUE(almost_equal(SpMatrix<double>(plan.Psi()), "../data/mtx/lagrangian_pointwise_eval_order2.mtx"));
+    // evaluate a matrix of coefficients, each column being a different basis expansion
+    DMatrix<double> c = DMatrix<double>::Random(basis.size(), 5);
+    DMatrix<double> evals = plan(c);
+    EXPECT_TRUE(evals.rows() == locs.rows() && evals.cols() == 5);
+    for (int i = 0; i < c.cols(); ++i) {
+        EXPECT_TRUE(almost_equal(DMatrix<double>(evals.col(i)), DMatrix<double>(basis(c.col(i), locs))));
+    }
+}
+
+// parallel construction of \Psi does not depend on the number of threads
+TEST(lagrangian_basis_test, order1_parallel_pointwise_evaluation) {
+    MeshLoader<Triangulation<2, 2>> domain("unit_square");
+    LagrangianBasis<Triangulation<2, 2>, 1> basis(domain.mesh);
+    auto sample = domain.sample(10000);
+    DMatrix<double> locs(sample.size(), 2);
+    for (std::size_t i = 0; i < sample.size(); ++i) { locs.row(i) = sample[i].second; }
+    auto serial_plan = basis.evaluation_plan(locs, 1);
+    auto parallel_plan = basis.evaluation_plan(locs, 4);
+    EXPECT_TRUE(serial_plan.cell_ids() == parallel_plan.cell_ids());
+    EXPECT_TRUE(almost_equal(SpMatrix<double>(serial_plan.Psi()), SpMatrix<double>(parallel_plan.Psi())));
+    // lagrangian basis functions are a partition of unity
+    EXPECT_TRUE(almost_equal(DMatrix<double>(parallel_plan(DVector<double>::Ones(basis.size()))),
+                             DMatrix<double>(DVector<double>::Ones(locs.rows()))));
+}
+
+// areal evaluation with subdomains given as per-cell labels, sparse or binary incidence matrices
+TEST(lagrangian_basis_test, order2_areal_evaluation_sparse_incidence) {
+    MeshLoader<Triangulation<2, 2>> domain("quasi_circle");
+    LagrangianBasis<Triangulation<2, 2>, 2> basis(domain.mesh);
+    DMatrix<double> subdomains = read_csv<double>("../data/mesh/quasi_circle/incidence_matrix.csv");
+    // the subdomains of this test partition the domain, hence can be described by labels
+    DVector<int> labels = DVector<int>::Constant(subdomains.cols(), -1);
+    for (int k = 0; k < subdomains.rows(); ++k) {
+        for (int l = 0; l < subdomains.cols(); ++l) {
+            if (subdomains(k, l) == 1) labels[l] = k;
+        }
+    }
+    auto expected = basis.eval<fdapde::core::areal_evaluation>(subdomains);
+    auto res_labels = basis.eval<fdapde::core::areal_evaluation>(labels);
+    auto res_sparse = basis.eval<fdapde::core::areal_evaluation>(SpMatrix<double>(subdomains.sparseView()));
+    auto res_binary = basis.eval<fdapde::core::areal_evaluation>(fdapde::core::BinaryMatrix<fdapde::Dynamic>(subdomains));
+    EXPECT_TRUE(almost_equal(expected.first, "../data/mtx/lagrangian_areal_eval_order2.mtx"));
+    for (const auto& res : {res_labels, res_sparse, res_binary}) {
+        EXPECT_TRUE(almost_equal(res.first, expected.first));
+        EXPECT_TRUE(almost_equal(DMatrix<double>(res.second), DMatrix<double>(expected.second)));
+    }
+}
+
+// direct assembly of \Psi^\top W \Psi and \Psi^\top W y, without assembling \Psi
+TEST(lagrangian_basis_test, order2_gram_matrix) {
+    MeshLoader<Triangulation<2, 2>> domain("c_shaped");
+    LagrangianBasis<Triangulation<2, 2>, 2> basis(domain.mesh);
+    DMatrix<double> locs = read_csv<double>("../data/mesh/c_shaped/locs.csv");
+    DVector<double> w = DVector<double>::Random(locs.rows()).array() + 1.0;
+    DVector<double> y = DVector<double>::Random(locs.rows());
+    SpMatrix<double> Psi = basis.eval<fdapde::core::pointwise_evaluation>(locs).first;
+    auto [G, b] = basis.gram(locs, w, y);
+    EXPECT_TRUE(almost_equal(G, SpMatrix<double>(Psi.transpose() * w.asDiagonal() * Psi)));
+    EXPECT_TRUE(almost_equal(DMatrix<double>(b), DMatrix<double>(Psi.transpose() * w.asDiagonal() * y)));
+}
+
+// \Psi^\top W \Psi and \Psi^\top W y are bit-identical whatever the number of threads
+TEST(lagrangian_basis_test, order1_gram_matrix_reproducible) {
+    MeshLoader<Triangulation<2, 2>> domain("unit_square");
+    LagrangianBasis<Triangulation<2, 2>, 1> basis(domain.mesh);
+    DMatrix<double> locs = (DMatrix<double>::Random(20000, 2).array() + 1.0) / 2;
+    DVector<double> w = DVector<double>::Random(locs.rows()).array() + 1.0;
+    DVector<double> y = DVector<double>::Random(locs.rows());
+    auto [G, b] = basis.gram(locs, w, y, 1);
+    for (int n_threads : {2, 8, 32}) {
+        auto [G_, b_] = basis.gram(locs, w, y, n_threads);
+        EXPECT_TRUE(SpMatrix<double>(G - G_).norm() == 0);
+        EXPECT_TRUE(b == b_);
+    }
+}
+
+// out-of-core assembly of \Psi^\top W \Psi and \Psi^\top W y, reading locations and data from disk in blocks
+TEST(lagrangian_basis_test, order2_streaming_gram_matrix) {
+    MeshLoader<Triangulation<2, 2>> domain("c_shaped");
+    LagrangianBasis<Triangulation<2, 2>, 2> basis(domain.mesh);
+    DMatrix<double> locs = read_csv<double>("../data/mesh/c_shaped/locs.csv");
+    DVector<double> w = DVector<double>::Random(locs.rows()).array() + 1.0;
+    DVector<double> y = DVector<double>::Random(locs.rows());
+    // dump data in .csv format
+    std::filesystem::path tmp = std::filesystem::temp_directory_path();
+    std::string locs_file = (tmp / "streaming_gram_locs.csv").string(), data_file = (tmp / "streaming_gram_data.csv").string();
+    std::ofstream locs_stream(locs_file), data_stream(data_file);
+    locs_stream.precision(17);
+    data_stream.precision(17);
+    locs_stream << "\"\",\"x\",\"y\"\n";
+    data_stream << "\"\",\"y\",\"w\"\n";
+    for (int i = 0; i < locs.rows(); ++i) {
+        locs_stream << "\"" << i + 1 << "\"," << locs(i, 0) << "," << locs(i, 1) << "\n";
+        data_stream << "\"" << i + 1 << "\"," << y[i] << "," << w[i] << "\n";
+    }
+    locs_stream.close();
+    data_stream.close();
+    auto expected = basis.gram(locs, w, y);
+    for (int chunk_size : {7, 64, 100000}) {
+        auto [G, b] = streaming_gram(basis, locs_file, data_file, chunk_size, 4);
+        EXPECT_TRUE(almost_equal(G, expected.first));
+        EXPECT_TRUE(almost_equal(DMatrix<double>(b), DMatrix<double>(expected.second)));
+    }
+    std::filesystem::remove(locs_file);
+    std::filesystem::remove(data_file);
+}
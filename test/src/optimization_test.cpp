@@ -22,9 +22,12 @@
 #include <fdaPDE/optimization.h>
 using fdapde::core::Optimizer;
 using fdapde::core::BFGS;
+using fdapde::core::LBFGS;
+using fdapde::core::CachedObjective;
 using fdapde::core::GradientDescent;
 using fdapde::core::Grid;
 using fdapde::core::Newton;
+using fdapde::core::NewtonCG;
 using fdapde::core::BacktrackingLineSearch;
 using fdapde::core::WolfeLineSearch;
 using fdapde::core::ScalarField;
@@ -53,6 +56,43 @@ TEST(optimization_test, grid_search) {
     EXPECT_TRUE(almost_equal(opt.optimum()[0], 0.0) && almost_equal(opt.optimum()[1], 0.0));
 }
 
+// an objective with internal state, evaluated by thread-local copies in parallel grid search
+struct StatefulObjective {
+    DVector<double> buffer = DVector<double>::Zero(100);
+    double operator()(const SVector<1>& x) {
+        for (int i = 0; i < buffer.rows(); ++i) { buffer[i] = std::sin(x[0] * i); }
+        return buffer.squaredNorm() / buffer.rows() + std::pow(x[0] - 0.3, 2);
+    }
+};
+// stops the search as soon as the grid point exceeds a threshold
+struct StopAbove {
+    double threshold;
+    template <typename Opt, typename Obj> bool post_update_step(Opt& opt, [[maybe_unused]] Obj& obj) {
+        return opt.x_current[0] > threshold;
+    }
+};
+
+TEST(optimization_test, parallel_grid_search) {
+    Eigen::Matrix<double, Eigen::Dynamic, 1> grid = Eigen::Matrix<double, Eigen::Dynamic, 1>::LinSpaced(200, -1, 1);
+    fdapde::core::ThreadPool pool(4);
+    StatefulObjective f;
+    // sequential and parallel search select the same optimum, having the same evaluations
+    Grid<1> seq_opt, par_opt;
+    par_opt.set_execution_policy(fdapde::core::execution::chunked_policy {8, &pool});
+    seq_opt.optimize(f, grid);
+    par_opt.optimize(f, grid);
+    EXPECT_TRUE(seq_opt.optimum() == par_opt.optimum() && seq_opt.value() == par_opt.value());
+    EXPECT_TRUE(seq_opt.evaluations() == par_opt.evaluations());
+    EXPECT_TRUE((par_opt.timings().array() >= 0).all());
+    // callbacks keep their meaning, the search stops at the same row
+    Grid<1, StopAbove> seq_stop(StopAbove {-0.5}), par_stop(StopAbove {-0.5});
+    par_stop.set_execution_policy(fdapde::core::execution::chunked_policy {8, &pool});
+    seq_stop.optimize(f, grid);
+    par_stop.optimize(f, grid);
+    EXPECT_TRUE(seq_stop.optimum() == par_stop.optimum() && seq_stop.value() == par_stop.value());
+    EXPECT_TRUE(seq_stop.optimum()[0] < -0.49 && seq_stop.value() >= seq_opt.value());
+}
+
 TEST(optimization_test, gradient_descent_backtracking_line_search) {
     // define objective function: x*e^{-x^2 - y^2} + (x^2 + y^2)/20
     ScalarField<2> f;
@@ -109,3 +149,147 @@ TEST(optimization_test, type_erased_bfgs_wolfe_line_search) {
     double L2_error = (opt.optimum() - expected).norm();
     EXPECT_TRUE(L2_error < 1e-6);
 }
+
+TEST(optimization_test, type_erased_lbfgs_wolfe_line_search) {
+    // define objective function: x*e^{-x^2 - y^2} + (x^2 + y^2)/20
+    ScalarField<2> f;
+    f = [](SVector<2> x) -> double {
+        return x[0] * std::exp(-x[0] * x[0] - x[1] * x[1]) + (x[0] * x[0] + x[1] * x[1]) / 20;
+    };
+    f.set_step(1e-4);
+
+    // define optimizer
+    Optimizer<ScalarField<2>> opt = LBFGS<2, WolfeLineSearch>(1000, 1e-6, 0.01, 5);   // use a type erasure wrapper
+    // perform optimization
+    SVector<2> pt(-1, -1);
+    opt.optimize(f, pt);
+
+    // expected solution
+    SVector<2> expected(-0.6690718221499544, 0);
+    double L2_error = (opt.optimum() - expected).norm();
+    EXPECT_TRUE(L2_error < 1e-6);
+}
+
+// extended Rosenbrock function \sum_i 100*(x_{2i+1} - x_{2i}^2)^2 + (1 - x_{2i})^2, with minimum at (1, 1, ..., 1)
+struct ExtendedRosenbrock {
+    static constexpr int DomainDimension = fdapde::Dynamic;
+    double operator()(const DVector<double>& x) const {
+        double value = 0;
+        for (int i = 0; i < x.rows(); i += 2) {
+            value += 100 * std::pow(x[i + 1] - x[i] * x[i], 2) + std::pow(1 - x[i], 2);
+        }
+        return value;
+    }
+    auto derive() const {
+        return [](const DVector<double>& x) -> DVector<double> {
+            DVector<double> grad(x.rows());
+            for (int i = 0; i < x.rows(); i += 2) {
+                grad[i] = -400 * x[i] * (x[i + 1] - x[i] * x[i]) - 2 * (1 - x[i]);
+                grad[i + 1] = 200 * (x[i + 1] - x[i] * x[i]);
+            }
+            return grad;
+        };
+    }
+};
+
+TEST(optimization_test, lbfgs_high_dimensional) {
+    ExtendedRosenbrock f;
+    int n = 10000;
+    DVector<double> x0(n);
+    for (int i = 0; i < n; i += 2) { x0[i] = -1.2, x0[i + 1] = 1; }
+    // O(mN) memory, a dense N x N inverse hessian approximation would require 800MB here
+    LBFGS<fdapde::Dynamic, WolfeLineSearch> opt(1000, 1e-8, 1.0);
+    opt.optimize(f, x0);
+    EXPECT_TRUE((opt.optimum() - DVector<double>::Ones(n)).lpNorm<Eigen::Infinity>() < 1e-6);
+    EXPECT_TRUE(opt.value() < 1e-10);
+}
+
+// extended Rosenbrock function exposing analytical hessian-vector products
+struct ExtendedRosenbrockHessp : public ExtendedRosenbrock {
+    DVector<double> hessp(const DVector<double>& x, const DVector<double>& v) const {
+        DVector<double> Hv(x.rows());
+        for (int i = 0; i < x.rows(); i += 2) {
+            Hv[i] = (1200 * x[i] * x[i] - 400 * x[i + 1] + 2) * v[i] - 400 * x[i] * v[i + 1];
+            Hv[i + 1] = -400 * x[i] * v[i] + 200 * v[i + 1];
+        }
+        return Hv;
+    }
+};
+
+TEST(optimization_test, newton_cg_high_dimensional) {
+    int n = 10000;
+    DVector<double> x0(n);
+    for (int i = 0; i < n; i += 2) { x0[i] = -1.2, x0[i + 1] = 1; }
+    // hessian-vector products by finite differences of the gradient, a dense hessian would require 800MB here
+    ExtendedRosenbrock f;
+    NewtonCG<fdapde::Dynamic, WolfeLineSearch> opt(1000, 1e-8, 1.0);
+    opt.optimize(f, x0);
+    EXPECT_TRUE((opt.optimum() - DVector<double>::Ones(n)).lpNorm<Eigen::Infinity>() < 1e-6);
+    EXPECT_TRUE(opt.value() < 1e-10);
+    // user supplied hessian-vector products
+    ExtendedRosenbrockHessp g;
+    NewtonCG<fdapde::Dynamic, WolfeLineSearch> opt_hessp(1000, 1e-8, 1.0);
+    opt_hessp.optimize(g, x0);
+    EXPECT_TRUE((opt_hessp.optimum() - DVector<double>::Ones(n)).lpNorm<Eigen::Infinity>() < 1e-6);
+    EXPECT_TRUE(opt_hessp.value() < 1e-10);
+}
+
+TEST(optimization_test, type_erased_newton_cg_backtracking_line_search) {
+    // define objective function: x*e^{-x^2 - y^2} + (x^2 + y^2)/20
+    ScalarField<2> f;
+    f = [](SVector<2> x) -> double {
+        return x[0] * std::exp(-x[0] * x[0] - x[1] * x[1]) + (x[0] * x[0] + x[1] * x[1]) / 20;
+    };
+    f.set_step(1e-4);
+
+    // define optimizer
+    Optimizer<ScalarField<2>> opt =
+      NewtonCG<2, BacktrackingLineSearch>(1000, 1e-6, 0.01);   // use a type erasure wrapper
+    // perform optimization
+    SVector<2> pt(-1, -1);
+    opt.optimize(f, pt);
+
+    // expected solution
+    SVector<2> expected(-0.6690718221499544, 0);
+    double L2_error = (opt.optimum() - expected).norm();
+    EXPECT_TRUE(L2_error < 1e-6);
+}
+
+// extended Rosenbrock function counting its evaluations
+struct CountingRosenbrock {
+    static constexpr int DomainDimension = fdapde::Dynamic;
+    ExtendedRosenbrock f;
+    int n_evals = 0, n_grad_evals = 0;
+    double operator()(const DVector<double>& x) {
+        n_evals++;
+        return f(x);
+    }
+    auto derive() {
+        return [this](const DVector<double>& x) -> DVector<double> {
+            n_grad_evals++;
+            return f.derive()(x);
+        };
+    }
+};
+
+TEST(optimization_test, cached_objective) {
+    DVector<double> x0(100);
+    for (int i = 0; i < x0.rows(); i += 2) { x0[i] = -1.2, x0[i + 1] = 1; }
+    // plain objective
+    CountingRosenbrock f;
+    LBFGS<fdapde::Dynamic, WolfeLineSearch> opt(1000, 1e-8, 1.0);
+    opt.optimize(f, x0);
+    // same objective, behind a cache
+    CountingRosenbrock g;
+    CachedObjective cached(g);
+    Optimizer<CachedObjective<CountingRosenbrock>> cached_opt =
+      LBFGS<fdapde::Dynamic, WolfeLineSearch>(1000, 1e-8, 1.0);   // use a type erasure wrapper
+    cached_opt.optimize(cached, x0);
+    // same iterates, fewer evaluations of g
+    EXPECT_TRUE(cached_opt.optimum() == opt.optimum());
+    EXPECT_TRUE(cached_opt.value() == opt.value());
+    EXPECT_TRUE(cached.n_evaluations() == g.n_evals && cached.n_gradient_evaluations() == g.n_grad_evals);
+    EXPECT_TRUE(g.n_evals < f.n_evals);
+    EXPECT_TRUE(g.n_grad_evals < f.n_grad_evals);
+    EXPECT_TRUE(cached.n_hits() > 0);
+}
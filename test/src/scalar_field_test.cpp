@@ -347,6 +347,47 @@ TEST(scalar_field_test, expression_differentials_approximation) {
     ASSERT_TRUE((hess(p) - hessian).norm() < 1e-6);
 }
 
+// check derive() and derive_twice() are exact for fields wrapping a generic callable
+TEST(scalar_field_test, automatic_differentiation) {
+    auto fieldExpr = [](const auto& x) {   // [e^(2x+y)]/x
+        using std::exp;
+        return exp(2 * x[0] + x[1]) / x[0];
+    };
+    ScalarField<2, decltype(fieldExpr)> field(fieldExpr);
+    SVector<2> p(1, 1);
+    // no truncation error, regardless of the step size
+    SVector<2> gradient = SVector<2>(std::exp(3), std::exp(3));
+    EXPECT_TRUE((field.derive()(p) - gradient).norm() < DOUBLE_TOLERANCE);
+    SMatrix<2> hessian;
+    hessian << 2 * std::exp(3), std::exp(3), std::exp(3), std::exp(3);
+    EXPECT_TRUE((field.derive_twice()(p) - hessian).norm() < DOUBLE_TOLERANCE);
+
+    // automatic differentiation propagates through expressions
+    auto linearExpr = [](const auto& x) { return x[0] + x[1]; };
+    ScalarField<2, decltype(linearExpr)> f(linearExpr);
+    auto expr = sin(f) + 2 * f;
+    gradient << std::cos(2) + 2, std::cos(2) + 2;
+    EXPECT_TRUE((expr.derive()(p) - gradient).norm() < DOUBLE_TOLERANCE);
+    hessian << -std::sin(2), -std::sin(2), -std::sin(2), -std::sin(2);
+    EXPECT_TRUE((expr.derive_twice()(p) - hessian).norm() < DOUBLE_TOLERANCE);
+
+    // and through dot products of vector expressions
+    auto component = [](int i) { return [i](const auto& x) { return x[i] * x[i]; }; };
+    using ComponentType = decltype(component(0));
+    VectorField<2, 2, ComponentType> v(std::vector<ComponentType> {component(0), component(1)});
+    SVector<2> w(3, 4);
+    auto dot = v.dot(w);   // 3x^2 + 4y^2
+    EXPECT_TRUE((dot.derive()(p) - SVector<2>(6, 8)).norm() < DOUBLE_TOLERANCE);
+
+    // dynamic fields
+    auto sumOfSquares = [](const auto& x) { return x.dot(x); };
+    ScalarField<Dynamic, decltype(sumOfSquares)> g(sumOfSquares);
+    g.resize(4);
+    DVector<double> q(4);
+    q << 1, 2, 3, 4;
+    EXPECT_TRUE((g.derive()(q) - 2 * q).norm() < DOUBLE_TOLERANCE);
+}
+
 double f_impl(SVector<2> x) { return x[0]; }
 
 struct g_container { int i = 0; };
@@ -0,0 +1,108 @@
+// This file is part of fdaPDE, a C++ library for physics-informed
+// spatial and functional data analysis.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <gtest/gtest.h>   // testing framework
+#include <cstddef>
+
+#include <fdaPDE/linear_algebra.h>
+using fdapde::core::BlockDiagonalPreconditioner;
+using fdapde::core::GMRES;
+using fdapde::core::MINRES;
+using fdapde::core::SchurComplementPreconditioner;
+using fdapde::core::SparseBlockMatrix;
+
+#include "utils/utils.h"
+using fdapde::testing::almost_equal;
+
+// builds the saddle point matrix [A B^\top; B -C], with A, C symmetric positive definite
+SparseBlockMatrix<double, 2, 2> saddle_point_matrix(int n1, int n2) {
+    std::vector<fdapde::Triplet<double>> triplet_list;
+    for (int i = 0; i < n1; ++i) {
+        triplet_list.emplace_back(i, i, 4.0);
+        if (i > 0) triplet_list.emplace_back(i, i - 1, -1.0);
+        if (i < n1 - 1) triplet_list.emplace_back(i, i + 1, -1.0);
+    }
+    SpMatrix<double> A(n1, n1);
+    A.setFromTriplets(triplet_list.begin(), triplet_list.end());
+    triplet_list.clear();
+    for (int i = 0; i < n2; ++i) {
+        triplet_list.emplace_back(i, i, 2.0);
+        if (i > 0) triplet_list.emplace_back(i, i - 1, 0.5);
+        if (i < n2 - 1) triplet_list.emplace_back(i, i + 1, 0.5);
+    }
+    SpMatrix<double> C(n2, n2);
+    C.setFromTriplets(triplet_list.begin(), triplet_list.end());
+    SpMatrix<double> B = DMatrix<double>::Random(n2, n1).sparseView(0.6, 1.0);
+    SpMatrix<double> Bt = B.transpose();
+    SpMatrix<double> mC = -C;
+    return SparseBlockMatrix<double, 2, 2>(A, Bt, B, mC);
+}
+
+TEST(sparse_block_matrix_test, block_product) {
+    SparseBlockMatrix<double, 2, 2> K = saddle_point_matrix(30, 20);
+    SpMatrix<double> K_ = K;
+    DMatrix<double> x = DMatrix<double>::Random(50, 3);
+    EXPECT_TRUE(almost_equal(DMatrix<double>(K * x), DMatrix<double>(K_ * x)));
+    // coefficient access
+    for (int i = 0; i < 50; i += 7) {
+        for (int j = 0; j < 50; j += 3) { EXPECT_TRUE(K.coeff(i, j) == K_.coeff(i, j)); }
+    }
+}
+
+TEST(sparse_block_matrix_test, preconditioned_minres) {
+    SparseBlockMatrix<double, 2, 2> K = saddle_point_matrix(60, 40);
+    DVector<double> b = DVector<double>::Random(100);
+    SpMatrix<double> K_ = K;
+    Eigen::SparseLU<SpMatrix<double>> lu(K_);
+    DVector<double> expected = lu.solve(b);
+
+    MINRES<SparseBlockMatrix<double, 2, 2>, BlockDiagonalPreconditioner> solver(K);
+    solver.setTolerance(1e-12);
+    DVector<double> x = solver.solve(b);
+    EXPECT_TRUE(solver.info() == Eigen::Success);
+    EXPECT_TRUE((x - expected).norm() < 1e-8 * expected.norm());
+    // the preconditioner reduces the number of iterations
+    MINRES<SparseBlockMatrix<double, 2, 2>> unpreconditioned_solver(K);
+    unpreconditioned_solver.setTolerance(1e-12);
+    x = unpreconditioned_solver.solve(b);
+    EXPECT_TRUE((x - expected).norm() < 1e-8 * expected.norm());
+    EXPECT_TRUE(solver.iterations() < unpreconditioned_solver.iterations());
+}
+
+TEST(sparse_block_matrix_test, schur_complement_preconditioned_gmres) {
+    SparseBlockMatrix<double, 2, 2> K = saddle_point_matrix(60, 40);
+    DVector<double> b = DVector<double>::Random(100);
+    SpMatrix<double> K_ = K;
+    Eigen::SparseLU<SpMatrix<double>> lu(K_);
+    DVector<double> expected = lu.solve(b);
+
+    GMRES<SparseBlockMatrix<double, 2, 2>, SchurComplementPreconditioner> solver(K);
+    solver.setTolerance(1e-12);
+    DVector<double> x = solver.solve(b);
+    EXPECT_TRUE(solver.info() == Eigen::Success);
+    EXPECT_TRUE((x - expected).norm() < 1e-8 * expected.norm());
+    // with the exact Schur complement GMRES converges in (at most) two iterations
+    DMatrix<double> A = DMatrix<double>(K.block(0, 0));
+    SpMatrix<double> S = (-DMatrix<double>(K.block(1, 1)) +
+                          DMatrix<double>(K.block(1, 0)) * A.inverse() * DMatrix<double>(K.block(0, 1))).sparseView();
+    GMRES<SparseBlockMatrix<double, 2, 2>, SchurComplementPreconditioner> exact_solver;
+    exact_solver.analyzePattern(K);
+    exact_solver.preconditioner().compute(K.block(0, 0), K.block(0, 1), S);
+    exact_solver.setTolerance(1e-10);
+    x = exact_solver.solve(b);
+    EXPECT_TRUE(exact_solver.info() == Eigen::Success && exact_solver.iterations() <= 2);
+    EXPECT_TRUE((x - expected).norm() < 1e-8 * expected.norm());
+}
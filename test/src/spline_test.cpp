@@ -20,6 +20,7 @@
 
 #include <unsupported/Eigen/SparseExtra>
 using fdapde::core::Assembler;
+using fdapde::core::BandedLU;
 using fdapde::core::bilaplacian;
 using fdapde::core::GaussLegendre;
 using fdapde::core::IntegratorTable;
@@ -81,6 +82,39 @@ TEST(spline_test, cubic_spline_second_derivative) {
     }
 }
 
+// test evaluation of the nonzero splines (and their derivatives) over a knot span
+TEST(spline_test, cubic_spline_nonzero_evaluation) {
+    // define vector of non-equidistant knots on unit interval [0,1]
+    DVector<double> knots;
+    knots.resize(11);
+    for (int i = 0; i < 11; ++i) knots[i] = std::pow(0.1 * i, 2);
+
+    // define cubic B-spline basis over [0,1]
+    SplineBasis<3> basis(knots);
+
+    SMatrix<3, 4> ders;
+    double h = 1e-6;
+    for (double x = 0.005; x < 1; x += 0.01) {
+        int s = basis.eval_nonzero<2>(x, ders);
+        EXPECT_TRUE(basis.knots()[s] <= x && x < basis.knots()[s + 1]);
+        // partition of unity
+        EXPECT_TRUE(almost_equal(ders.row(0).sum(), 1.0));
+        EXPECT_TRUE(std::abs(ders.row(1).sum()) < 1e-9 && std::abs(ders.row(2).sum()) < 1e-7);
+        for (int j = 0; j < 4; ++j) {
+            int i = s - 3 + j;
+            EXPECT_TRUE(almost_equal(ders(0, j), basis[i](SVector<1>(x))));
+            EXPECT_TRUE(almost_equal(ders(2, j), basis[i].derive<2>()(SVector<1>(x))));
+            // first derivative by central finite differences
+            double fd = (basis[i](SVector<1>(x + h)) - basis[i](SVector<1>(x - h))) / (2 * h);
+            EXPECT_TRUE(std::abs(ders(1, j) - fd) < 1e-5 * std::max(1.0, std::abs(fd)));
+        }
+    }
+    // right end of the domain belongs to the last span
+    SMatrix<1, 4> values;
+    EXPECT_TRUE(basis.eval_nonzero(1.0, values) == basis.size() - 1 && almost_equal(values[3], 1.0));
+    EXPECT_TRUE(basis.knot_span(1.1) == -1 && basis.knot_span(-0.1) == -1);
+}
+
 TEST(spline_test, cubic_spline_reaction_operator) {
     Triangulation<1, 1> unit_interval(0, 2, 10);
     // define PDE
@@ -106,3 +140,48 @@ TEST(spline_test, cubic_spline_bilaplacian_operator) {
 }
 
 
+TEST(spline_test, banded_lu_solver) {
+    Triangulation<1, 1> unit_interval(0, 2, 10);
+    auto L = reaction<SPLINE>(1.0);
+    PDE<Triangulation<1, 1>, decltype(L), DMatrix<double>, SPLINE, spline_order<3>> pde_(unit_interval, L);
+    pde_.init();
+    // banded LU of the (banded) stiff matrix against sparse LU
+    DMatrix<double> b = DMatrix<double>::Random(pde_.stiff().rows(), 2);
+    BandedLU<double> banded_lu(pde_.stiff());
+    EXPECT_TRUE(banded_lu.info() == Eigen::Success && banded_lu.lower_bandwidth() == 3);
+    Eigen::SparseLU<SpMatrix<double>> sparse_lu(pde_.stiff());
+    EXPECT_TRUE(almost_equal(banded_lu.solve(b), DMatrix<double>(sparse_lu.solve(b))));
+    // non-symmetric banded matrix requiring row interchanges
+    int n = 50;
+    std::vector<fdapde::Triplet<double>> triplet_list;
+    for (int i = 0; i < n; ++i) {
+        for (int j = std::max(0, i - 2); j <= std::min(n - 1, i + 1); ++j) {
+            triplet_list.emplace_back(i, j, i == j ? 1e-3 : 1.0 + 0.01 * (i + 2 * j));
+        }
+    }
+    SpMatrix<double> A(n, n);
+    A.setFromTriplets(triplet_list.begin(), triplet_list.end());
+    DVector<double> x = DVector<double>::Random(n);
+    banded_lu.compute(A);
+    EXPECT_TRUE(banded_lu.info() == Eigen::Success);
+    EXPECT_TRUE((banded_lu.solve(A * x) - x).norm() < 1e-10 * x.norm());
+}
+
+TEST(spline_test, cubic_spline_pointwise_evaluation) {
+    DVector<double> knots;
+    knots.resize(11);
+    for (int i = 0; i < 11; ++i) knots[i] = std::pow(0.1 * i, 2);
+    SplineBasis<3> basis(knots);
+    // locations on a dense grid, including knots and the domain boundary
+    DVector<double> locs = DVector<double>::LinSpaced(1001, 0, 1);
+    SpMatrix<double> Phi = basis.eval<fdapde::core::pointwise_evaluation>(locs).first;
+    DMatrix<double> expected(locs.rows(), basis.size());
+    for (int i = 0; i < locs.rows(); ++i) {
+        for (int j = 0; j < basis.size(); ++j) { expected(i, j) = basis[j](SVector<1>(locs[i])); }
+    }
+    EXPECT_TRUE(almost_equal(DMatrix<double>(Phi), expected));
+    EXPECT_TRUE(Phi.nonZeros() <= locs.rows() * 4);
+    // evaluation of a basis expansion
+    DVector<double> c = DVector<double>::Random(basis.size());
+    EXPECT_TRUE(almost_equal(DMatrix<double>(basis(c, locs)), DMatrix<double>(expected * c)));
+}
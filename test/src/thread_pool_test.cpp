@@ -0,0 +1,150 @@
+// This file is part of fdaPDE, a C++ library for physics-informed
+// spatial and functional data analysis.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <gtest/gtest.h>   // testing framework
+#include <atomic>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <fdaPDE/multithreading.h>
+using fdapde::core::BlockingQueue;
+using fdapde::core::ConcurrentQueue;
+using fdapde::core::ThreadPool;
+
+// test parallel loops visit each index exactly once, also when called from inside a task
+TEST(thread_pool_test, parallel_for) {
+    ThreadPool pool(4);
+    std::vector<int> visits(100000, 0);
+    pool.parallel_for(0, visits.size(), 100, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) visits[i]++;
+    });
+    EXPECT_TRUE(std::all_of(visits.begin(), visits.end(), [](int v) { return v == 1; }));
+    // nested loops
+    std::vector<std::atomic<int>> nested_visits(64 * 1000);
+    pool.parallel_for(0, 64, 1, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            pool.parallel_for(0, 1000, 10, [&](int b, int e) {
+                for (int j = b; j < e; ++j) nested_visits[i * 1000 + j]++;
+            });
+        }
+    });
+    EXPECT_TRUE(std::all_of(nested_visits.begin(), nested_visits.end(), [](const std::atomic<int>& v) {
+        return v.load() == 1;
+    }));
+    // exceptions raised by a chunk are propagated to the caller
+    EXPECT_THROW(
+      pool.parallel_for(
+        0, 1000, 1,
+        [](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                if (i == 500) throw std::runtime_error("failure");
+            }
+        }),
+      std::runtime_error);
+}
+
+TEST(thread_pool_test, parallel_reduce) {
+    ThreadPool pool(4);
+    std::vector<long long> v(100000);
+    std::iota(v.begin(), v.end(), 0);
+    long long sum = pool.parallel_reduce(
+      0, v.size(), 64, 0LL,
+      [&](int begin, int end) {
+          long long partial = 0;
+          for (int i = begin; i < end; ++i) partial += v[i];
+          return partial;
+      },
+      std::plus<long long>());
+    EXPECT_TRUE(sum == 100000LL * 99999LL / 2);
+    // chunks are reduced in their natural order
+    std::vector<int> order = pool.parallel_reduce(
+      0, 1000, 10, std::vector<int>(),
+      [](int begin, int) { return std::vector<int>(1, begin); },
+      [](std::vector<int> lhs, const std::vector<int>& rhs) {
+          lhs.insert(lhs.end(), rhs.begin(), rhs.end());
+          return lhs;
+      });
+    EXPECT_TRUE(order.size() == static_cast<std::size_t>(pool.n_chunks(1000, 10)));
+    EXPECT_TRUE(std::is_sorted(order.begin(), order.end()) && order.front() == 0);
+}
+
+TEST(thread_pool_test, async_jobs) {
+    ThreadPool pool(2);
+    std::atomic<int> counter = 0;
+    std::vector<std::future<int>> results;
+    for (int i = 0; i < 100; ++i) {
+        results.push_back(pool.send_async([&counter](int x) {
+            counter++;
+            return x * x;
+        }, i));
+    }
+    pool.sync();
+    EXPECT_TRUE(counter.load() == 100);
+    for (int i = 0; i < 100; ++i) { EXPECT_TRUE(results[i].get() == i * i); }
+}
+
+TEST(thread_pool_test, concurrent_queue) {
+    // sequential FIFO behaviour on a bounded queue
+    ConcurrentQueue<int> queue(5);
+    EXPECT_TRUE(queue.capacity() == 8);
+    for (int i = 0; i < 8; ++i) { EXPECT_TRUE(queue.try_push(i)); }
+    EXPECT_FALSE(queue.try_push(8));   // queue full
+    EXPECT_TRUE(queue.size() == 8);
+    for (int i = 0; i < 8; ++i) { EXPECT_TRUE(queue.pop().value() == i); }
+    EXPECT_FALSE(queue.pop().has_value());
+    // multiple producers and consumers, each item is extracted exactly once
+    int n_items = 100000, n_threads = 4;
+    ConcurrentQueue<int> mpmc_queue(64);
+    std::vector<std::atomic<int>> extracted(n_items);
+    std::atomic<int> n_extracted = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < n_threads; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = t; i < n_items; i += n_threads) mpmc_queue.push(i);
+        });
+        threads.emplace_back([&]() {
+            int value;
+            while (n_extracted.load() < n_items) {
+                if (mpmc_queue.pop(value)) {
+                    extracted[value]++;
+                    n_extracted++;
+                }
+            }
+        });
+    }
+    for (std::thread& t : threads) t.join();
+    EXPECT_TRUE(std::all_of(extracted.begin(), extracted.end(), [](const std::atomic<int>& v) {
+        return v.load() == 1;
+    }));
+    // blocking adapter: consumers sleep until data arrives, and are released once the queue is closed
+    BlockingQueue<int> blocking_queue(4);
+    std::atomic<long> sum = 0;
+    std::vector<std::thread> consumers;
+    for (int t = 0; t < n_threads; ++t) {
+        consumers.emplace_back([&]() {
+            int value;
+            while (blocking_queue.pop(value)) sum += value;
+        });
+    }
+    for (int i = 0; i < 1000; ++i) blocking_queue.push(i);
+    while (!blocking_queue.empty()) std::this_thread::yield();
+    blocking_queue.close();
+    for (std::thread& t : consumers) t.join();
+    EXPECT_TRUE(sum.load() == 1000 * 999 / 2);
+}